@@ -0,0 +1,102 @@
+// Checks that binary data survives being packed into 7-bit SysEx data bytes
+// and unpacked again, with both orders of the header bits, in one go and in
+// chunks. The results are printed to the Serial Monitor.
+
+#include <midimap.h>
+
+const uint8_t MaxLength = 21; // three full groups
+
+uint16_t failures = 0;
+
+uint16_t smaller(uint16_t a, uint16_t b) { return a < b ? a : b; }
+
+void check(bool ok, const __FlashStringHelper *what, uint16_t length) {
+  if (!ok) {
+    Serial.print(F("FAIL: "));
+    Serial.print(what);
+    Serial.print(F(", length "));
+    Serial.println(length);
+    ++failures;
+  }
+}
+
+// Every value of every byte, for every length up to MaxLength
+void checkRoundTrips(bool flip) {
+  uint8_t data[MaxLength], packed[packed8to7Length(MaxLength)];
+  uint8_t unpacked[MaxLength];
+  for (uint8_t length = 1; length <= MaxLength; ++length)
+    for (uint8_t pos = 0; pos < length; ++pos)
+      for (uint16_t value = 0; value <= 0xFF; ++value) {
+        for (uint8_t i = 0; i < length; ++i)
+          data[i] = i == pos ? value : 0x55 ^ (i * 37);
+        uint16_t packedLength = pack8to7(data, length, packed, flip);
+        uint16_t unpackedLength =
+          unpack7to8(packed, packedLength, unpacked, flip);
+        check(packedLength == packed8to7Length(length) &&
+                unpackedLength == length &&
+                memcmp(data, unpacked, length) == 0,
+              F("round trip"), length);
+      }
+}
+
+// The same data, packed and unpacked in chunks of every size
+void checkChunks(bool flip) {
+  const uint16_t length = 64;
+  uint8_t data[length], packed[packed8to7Length(length)];
+  uint8_t message[packed8to7Length(length) + 2];
+  uint8_t unpacked[length];
+  for (uint16_t i = 0; i < length; ++i)
+    data[i] = i * 73 + 11;
+  uint16_t packedLength = pack8to7(data, length, packed, flip);
+  message[0] = 0xF0;
+  memcpy(message + 1, packed, packedLength);
+  message[packedLength + 1] = 0xF7;
+
+  for (uint8_t chunk = 1; chunk <= 9; ++chunk) {
+    SysExPacker packer {flip};
+    uint8_t streamed[SysExPacker::maxPackedLength(length)];
+    uint16_t streamedLength = 0;
+    for (uint16_t i = 0; i < length; i += chunk)
+      streamedLength += packer.pack(data + i, smaller(chunk, length - i),
+                                    streamed + streamedLength);
+    streamedLength += packer.flush(streamed + streamedLength);
+    check(streamedLength == packedLength &&
+            memcmp(streamed, packed, packedLength) == 0,
+          F("SysExPacker"), chunk);
+
+    SysExUnpacker unpacker {flip};
+    uint16_t unpackedLength = 0;
+    for (uint16_t i = 0; i < packedLength + 2; i += chunk)
+      unpackedLength += unpacker.unpack(
+        message + i, smaller(chunk, packedLength + 2 - i),
+        unpacked + unpackedLength);
+    check(unpackedLength == length && memcmp(data, unpacked, length) == 0,
+          F("SysExUnpacker"), chunk);
+  }
+}
+
+// The header bits of the default order, as produced by the Arduino MIDI
+// library's encodeSysEx
+void checkBitOrder() {
+  const uint8_t data[] {0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x81};
+  uint8_t packed[8];
+  pack8to7(data, sizeof(data), packed);
+  check(packed[0] == 0x41 && packed[1] == 0x00 && packed[7] == 0x01,
+        F("default bit order"), sizeof(data));
+  pack8to7(data, 1, packed, true);
+  check(packed[0] == 0x01, F("flipped bit order"), 1);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial)
+    ;
+  checkBitOrder();
+  checkRoundTrips(false);
+  checkRoundTrips(true);
+  checkChunks(false);
+  checkChunks(true);
+  Serial.println(failures == 0 ? F("All checks passed") : F("Checks failed"));
+}
+
+void loop() {}
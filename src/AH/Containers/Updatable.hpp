@@ -19,6 +19,13 @@ AH_DIAGNOSTIC_WERROR() // Enable errors on warnings
 #include <AH/Settings/SettingsWrapper.hpp>
 #include <stddef.h>
 
+#if UPDATABLE_SCHEDULING
+#include <AH/Arduino-Wrapper.h> // micros
+#endif
+#if UPDATABLE_PROFILING
+#include <AH/Timing/UpdateProfile.hpp>
+#endif
+
 BEGIN_AH_NAMESPACE
 
 /**
@@ -91,11 +98,58 @@ class UpdatableCRTP : public DoublyLinkable<Derived> {
     static void __attribute__((always_inline))
     applyToAll(void (Derived::*method)(Args...), Args... args) {
         for (auto &el : updatables)
-            (el.*method)(args...);
+            applyTo(el, method, args...);
+    }
+
+    /// Call the given method on the given element, and record its duration
+    /// if @ref UPDATABLE_PROFILING is enabled.
+    template <class... Args>
+    static void __attribute__((always_inline))
+    applyTo(Derived &el, void (Derived::*method)(Args...), Args... args) {
+#if UPDATABLE_PROFILING
+        UpdateProfileScope scope(el.profile);
+#endif
+        (el.*method)(args...);
+    }
+
+    /// @}
+
+#if UPDATABLE_PROFILING
+  public:
+    /// @name Profiling
+    /// @{
+
+    /// Get the timing statistics of this element.
+    const UpdateProfile &getProfile() const { return profile; }
+    /// Clear the timing statistics of this element.
+    void resetProfile() { profile.reset(); }
+
+    /// Clear the timing statistics of all enabled instances.
+    static void resetAllProfiles() {
+        for (auto &el : updatables)
+            el.profile.reset();
+    }
+    /// Call `f(index, element)` for all enabled instances, in update order,
+    /// e.g. to inspect their profiles.
+    template <class F>
+    static void forEachProfile(F &&f) {
+        uint8_t index = 0;
+        for (auto &el : updatables)
+            f(index++, el);
+    }
+    /// Print the timing statistics of all enabled instances.
+    static void printAllProfiles(Print &os, const char *name) {
+        forEachProfile([&](uint8_t index, const Derived &el) {
+            el.getProfile().print(os, name, index);
+        });
     }
 
     /// @}
 
+  private:
+    UpdateProfile profile;
+#endif
+
   public:
     /// @name Enabling and disabling updatables
     /// @{
@@ -166,12 +220,27 @@ DoublyLinkedList<Derived> UpdatableCRTP<Derived>::updatables;
 
 struct NormalUpdatable {};
 
+/// Rate classes for @ref Updatable::setUpdateRate.
+enum class UpdateRate : uint8_t {
+    EveryLoop, ///< Update on every call to @ref Updatable::updateAll.
+    Fast,      ///< @ref UPDATE_PERIOD_FAST
+    Normal,    ///< @ref UPDATE_PERIOD_NORMAL
+    Slow,      ///< @ref UPDATE_PERIOD_SLOW
+    VerySlow,  ///< @ref UPDATE_PERIOD_VERY_SLOW
+};
+
 /**
  * @brief   A super class for object that have to be updated regularly.
  * 
  * All instances of this class are kept in a linked list, so it's easy to 
  * iterate over all of them to update them.
  * 
+ * Each updatable can have its own update period (see @ref setUpdatePeriod),
+ * and the time spent in @ref updateAll can be limited (see 
+ * @ref setUpdateBudget). Updatables that are due are then updated earliest
+ * deadline first, so slow elements can't starve the ones that have to be 
+ * updated more often.
+ * 
  * @nosubgrouping
  */
 template <class T = NormalUpdatable>
@@ -188,15 +257,154 @@ class Updatable : public UpdatableCRTP<Updatable<T>> {
 
     /// Begin all enabled instances of this class
     /// @see    begin()
-    static void beginAll() { Updatable::applyToAll(&Updatable::begin); }
+    static void beginAll() {
+#if UPDATABLE_SCHEDULING
+        unsigned long now = micros();
+        for (auto &el : Updatable::updatables)
+            el.deadline = now;
+#endif
+        Updatable::applyToAll(&Updatable::begin);
+    }
 
     /// Update all enabled instances of this class
     /// @see    update()
-    static void updateAll() { Updatable::applyToAll(&Updatable::update); }
+    static void updateAll() {
+#if UPDATABLE_SCHEDULING
+        updateAllScheduled();
+#else
+        Updatable::applyToAll(&Updatable::update);
+#endif
+    }
+
+    /// @}
+
+  public:
+    /// @name Scheduling
+    /// @{
+
+#if UPDATABLE_SCHEDULING
+    /// Update this element at most once every @p period microseconds.
+    /// A period of zero (the default) updates it on every loop.
+    void setUpdatePeriod(unsigned long period) {
+        this->period = period;
+        this->deadline = micros();
+    }
+    /// Get the update period of this element, in microseconds.
+    unsigned long getUpdatePeriod() const { return period; }
+
+    /// Limit the time spent by @ref updateAll in a single call, in 
+    /// microseconds. Elements that are due but don't fit in the budget are 
+    /// updated on the next call. Elements without an update period are always
+    /// updated. Zero (the default) means no limit: all due elements are then
+    /// updated in a single pass over the list, in list order. With a budget,
+    /// the due elements are selected earliest deadline first, which costs a
+    /// pass over the list per element.
+    static void setUpdateBudget(unsigned long budget) { 
+        Updatable::budget = budget; 
+    }
+    /// Get the number of times an element was updated more than one full
+    /// period after its deadline.
+    static unsigned long getMissedDeadlines() { return missedDeadlines; }
+    /// Reset the number of missed deadlines.
+    static void resetMissedDeadlines() { missedDeadlines = 0; }
+#else
+    void setUpdatePeriod(unsigned long) {}
+    unsigned long getUpdatePeriod() const { return 0; }
+    static void setUpdateBudget(unsigned long) {}
+    static unsigned long getMissedDeadlines() { return 0; }
+    static void resetMissedDeadlines() {}
+#endif
+
+    /// Set the update period of this element using a rate class.
+    void setUpdateRate(UpdateRate rate) { setUpdatePeriod(periodOf(rate)); }
 
     /// @}
+
+  private:
+    constexpr static unsigned long periodOf(UpdateRate rate) {
+        return rate == UpdateRate::Fast       ? UPDATE_PERIOD_FAST
+               : rate == UpdateRate::Normal   ? UPDATE_PERIOD_NORMAL
+               : rate == UpdateRate::Slow     ? UPDATE_PERIOD_SLOW
+               : rate == UpdateRate::VerySlow ? UPDATE_PERIOD_VERY_SLOW
+                                              : 0;
+    }
+
+#if UPDATABLE_SCHEDULING
+    /// Check if this element has to be updated. Deadlines more than one
+    /// period in the future are stale (e.g. after the element was disabled for
+    /// a long time), those elements are due as well.
+    bool isDue(unsigned long now) const {
+        unsigned long ahead = deadline - now;
+        return ahead == 0 || ahead > period;
+    }
+
+    /// Move the deadline of this element one period further, after it has
+    /// been updated late by @p late microseconds.
+    void advanceDeadline(unsigned long now, unsigned long late) {
+        if (late >= period)
+            ++missedDeadlines;
+        deadline += period;
+        // Don't try to catch up if we fell behind by more than a period
+        if (isDue(now))
+            deadline = now + period;
+    }
+
+    static void updateAllScheduled() {
+        unsigned long start = micros();
+        // Without a budget, all elements that are due get updated anyway, so
+        // the order doesn't matter: a single pass in list order suffices.
+        if (budget == 0) {
+            for (auto &el : Updatable::updatables) {
+                if (el.period != 0) {
+                    if (!el.isDue(start))
+                        continue;
+                    el.advanceDeadline(start, start - el.deadline);
+                }
+                Updatable::applyTo(el, &Updatable::update);
+            }
+            return;
+        }
+        // Elements without a period are updated on every call, in order
+        for (auto &el : Updatable::updatables)
+            if (el.period == 0)
+                Updatable::applyTo(el, &Updatable::update);
+        // Then the elements that were due at the start, earliest deadline
+        // first, until the budget runs out. Updating an element moves its
+        // deadline past the start, so each element is updated at most once
+        // per call.
+        while (micros() - start < budget) {
+            Updatable *next = nullptr;
+            unsigned long maxLate = 0;
+            for (auto &el : Updatable::updatables) {
+                if (el.period == 0 || !el.isDue(start))
+                    continue;
+                unsigned long late = start - el.deadline;
+                if (next == nullptr || late > maxLate) {
+                    next = &el;
+                    maxLate = late;
+                }
+            }
+            if (next == nullptr)
+                break;
+            next->advanceDeadline(start, maxLate);
+            Updatable::applyTo(*next, &Updatable::update);
+        }
+    }
+
+    unsigned long period = 0;
+    unsigned long deadline = 0;
+    static unsigned long budget;
+    static unsigned long missedDeadlines;
+#endif
 };
 
+#if UPDATABLE_SCHEDULING
+template <class T>
+unsigned long Updatable<T>::budget = 0;
+template <class T>
+unsigned long Updatable<T>::missedDeadlines = 0;
+#endif
+
 END_AH_NAMESPACE
 
 AH_DIAGNOSTIC_POP()
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <AH/Settings/Warnings.hpp>
+AH_DIAGNOSTIC_WERROR() // Enable errors on warnings
+
+#include "EMA.hpp"
+
+/**
+ * @brief   Applies an @ref EMA filter, a mapping function and @ref Hysteresis
+ *          to many channels at once.
+ *
+ * The result is exactly the same as using an `EMA<K, input_t, state_t>` and a
+ * `Hysteresis<HysteresisBits, input_t, input_t>` for each channel, like
+ * @ref AH::FilteredAnalog does, but the state of all channels is stored in
+ * arrays, and all channels are updated in a single loop without any indirect
+ * calls. The loop has no data-dependent branches, so compilers can vectorize
+ * it on targets with SIMD instructions.
+ *
+ * The inputs are read from a contiguous array, e.g. the samples of an
+ * @ref AH::AnalogScanGroup (after increasing their bit depth if necessary).
+ *
+ * @tparam  N
+ *          The number of channels.
+ * @tparam  K
+ *          The shift factor of the EMA filters, see @ref EMA.
+ * @tparam  HysteresisBits
+ *          The number of bits the hysteresis decreases the resolution by, see
+ *          @ref Hysteresis.
+ * @tparam  input_t
+ *          The unsigned integer type of the inputs and outputs. The default is
+ *          the same type as @ref AH::analog_t, so the samples of a scan group
+ *          can be passed to @ref update directly.
+ * @tparam  state_t
+ *          The unsigned integer type of the state of the EMA filters, see
+ *          @ref EMA.
+ *
+ * @ingroup    AH_Filters
+ */
+template <uint16_t N, uint8_t K, uint8_t HysteresisBits,
+          class input_t = uint16_t,
+          class state_t = typename std::make_unsigned<input_t>::type>
+class FilterBank {
+  public:
+    /// The EMA filter that is applied to each channel.
+    using EMA_t = EMA<K, input_t, state_t>;
+
+    /// Constructor: initialize all channels to zero or the given value.
+    FilterBank(input_t initial = input_t(0)) { resetAll(initial); }
+
+    /// Reset the filter and the hysteresis of one channel to the given value.
+    void reset(uint16_t channel, input_t value = input_t(0)) {
+        state[channel] = EMA_t::zero + (state_t(value) << K) - value;
+        levels[channel] = value >> HysteresisBits;
+        changed[channel] = false;
+    }
+
+    /// Reset the filters and the hysteresis of all channels to the given
+    /// value.
+    void resetAll(input_t value = input_t(0)) {
+        for (uint16_t i = 0; i < N; ++i)
+            reset(i, value);
+    }
+
+    /**
+     * @brief   Filter a new input value for every channel, apply the mapping
+     *          function, and then the hysteresis.
+     *
+     * @param   inputs
+     *          Array with one new raw input value per channel.
+     * @param   map
+     *          The mapping function, applied after filtering and before
+     *          hysteresis, like @ref AH::GenericFilteredAnalog::map. It should
+     *          accept and return an `input_t`, and it's inlined into the loop
+     *          if possible.
+     * @return  The number of channels whose output level changed.
+     */
+    template <class MappingFunction>
+    uint16_t update(const input_t *inputs, MappingFunction &&map) {
+        uint16_t numChanged = 0;
+        for (uint16_t i = 0; i < N; ++i) {
+            // EMA::filter, rounding without overflowing the state type (EMA
+            // computes in int if the state type is narrower)
+            state_t s = state[i] + state_t(inputs[i]);
+            state_t filtered = state_t(s >> K) +
+                               state_t(state_t((s & mask) + EMA_t::half) >> K) -
+                               state_t(EMA_t::zero >> K);
+            state[i] = s - filtered;
+            input_t mapped = map(input_t(filtered));
+            // Hysteresis::update, using non-short-circuiting operators
+            input_t level = levels[i];
+            input_t full = input_t(level << HysteresisBits) | offset;
+            bool c = ((level > 0) & (mapped < input_t(full - margin))) |
+                     ((level < max_out) & (mapped > input_t(full + margin)));
+            levels[i] = c ? input_t(mapped >> HysteresisBits) : level;
+            changed[i] = c;
+            numChanged += c;
+        }
+        return numChanged;
+    }
+
+    /// @copybrief update(const input_t *, MappingFunction &&)
+    /// Without a mapping function.
+    /// @param   inputs
+    ///          Array with one new raw input value per channel.
+    /// @return  The number of channels whose output level changed.
+    uint16_t update(const input_t *inputs) {
+        return update(inputs, [](input_t x) { return x; });
+    }
+
+    /// Get the output level of the given channel.
+    input_t getValue(uint16_t channel) const { return levels[channel]; }
+    /// Get the output levels of all channels.
+    const input_t *getValues() const { return levels; }
+    /// Check whether the output level of the given channel changed during the
+    /// last update.
+    bool hasChanged(uint16_t channel) const { return changed[channel]; }
+
+    /// The number of channels.
+    constexpr static uint16_t size() { return N; }
+
+  private:
+    constexpr static state_t mask = K > 0 ? (state_t(1) << K) - 1 : 0;
+    constexpr static input_t margin = (1ul << HysteresisBits) - 1ul;
+    constexpr static input_t offset =
+        HysteresisBits >= 1 ? 1ul << (HysteresisBits - 1) : 0;
+    constexpr static input_t max_out =
+        static_cast<input_t>(-1) >> HysteresisBits;
+    static_assert(std::is_unsigned<input_t>::value,
+                  "Error: only unsigned types are supported");
+
+    state_t state[N];
+    input_t levels[N];
+    bool changed[N];
+};
+
+AH_DIAGNOSTIC_POP()
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <AH/Settings/Warnings.hpp>
+AH_DIAGNOSTIC_WERROR() // Enable errors on warnings
+
+#include <AH/Arduino-Wrapper.h> // micros
+#include <AH/Settings/SettingsWrapper.hpp>
+
+#include <stdint.h>
+
+#ifdef __AVR__
+#include <AH/STL/limits>
+#include <AH/STL/type_traits>
+#else
+#include <limits>      // STL
+#include <type_traits> // STL
+#endif
+
+BEGIN_AH_NAMESPACE
+
+/**
+ * @brief   Speed-adaptive low-pass filter (the "1€ filter").
+ *
+ * An exponential moving average filter whose cut-off frequency increases with
+ * the speed of the input: slow movements are smoothed heavily, so the output
+ * doesn't jitter, while fast movements have little lag.
+ *
+ * @f[
+ * f_c = f_{c,\min} + \beta \left|\dot{\hat{x}}\right|, \qquad
+ * \alpha = \frac{2\pi f_c T}{1 + 2\pi f_c T}, \qquad
+ * \hat{x}[n] = \alpha\, x[n] + (1-\alpha)\, \hat{x}[n-1]
+ * @f]
+ * where @f$ \dot{\hat{x}} @f$ is the speed of the input, filtered with a
+ * fixed cut-off frequency, and @f$ T @f$ is the time since the previous
+ * sample (measured using `micros()`).
+ *
+ * Casiez, G., Roussel, N. and Vogel, D. (2012). 1€ Filter: A Simple
+ * Speed-based Low-pass Filter for Noisy Input in Interactive Systems.
+ *
+ * The parameters are floating point numbers, but they are converted to
+ * fixed-point coefficients when they're set, the filter itself only uses
+ * integer arithmetic. The state has 8 fractional bits.
+ *
+ * The filter can be used instead of the @ref EMA filter of
+ * @ref GenericFilteredAnalog and @ref FilteredTouch.
+ *
+ * @tparam  input_t
+ *          The integer type to use for the input and output of the filter.
+ *          Values must fit in 21 bits (plus sign).
+ *
+ * @ingroup    AH_Filters
+ */
+template <class input_t = uint_fast16_t>
+class OneEuroFilter {
+  public:
+    /// Constructor: initialize filter to zero or optional given value, using
+    /// the default parameters.
+    /// @see    ONE_EURO_MIN_CUTOFF, ONE_EURO_BETA, ONE_EURO_D_CUTOFF
+    OneEuroFilter(input_t initial = input_t(0)) {
+        setMinCutoff(ONE_EURO_MIN_CUTOFF);
+        setBeta(ONE_EURO_BETA);
+        setDerivativeCutoff(ONE_EURO_D_CUTOFF);
+        reset(initial);
+    }
+
+    /**
+     * @brief   Reset the filter to the given value.
+     *
+     * @param   value
+     *          The value to reset the filter state to.
+     */
+    void reset(input_t value = input_t(0)) {
+        state = int32_t(value) * (int32_t(1) << FracBits);
+        speed = 0;
+        lastTime = micros();
+    }
+
+    /**
+     * @brief   Filter the input: Given @f$ x[n] @f$, calculate
+     *          @f$ \hat{x}[n] @f$.
+     *
+     * @param   input
+     *          The new raw input value.
+     * @return  The new filtered output value.
+     */
+    input_t filter(input_t input) {
+        unsigned long now = micros();
+        uint32_t dt = now - lastTime;
+        lastTime = now;
+        if (dt == 0)
+            dt = 1;
+        else if (dt > MaxDt) // e.g. after a pause, don't jump to the input
+            dt = MaxDt;
+        int32_t x = int32_t(input) * (int32_t(1) << FracBits);
+        // Change per sample, filtered with a fixed cut-off frequency
+        speed += mul(alpha(omega(dCutoffCoef, dt)), x - state - speed);
+        // The beta term doesn't depend on the sampling period:
+        // 2π β |dx/dt| T = 2π β |dx|
+        uint32_t absSpeed = speed < 0 ? -uint32_t(speed) : uint32_t(speed);
+        uint64_t w = omega(minCutoffCoef, dt) +
+                     ((uint64_t(betaCoef) * absSpeed) >> (FracBits + 8));
+        if (w > MaxOmega)
+            w = MaxOmega;
+        state += mul(alpha(uint32_t(w)), x - state);
+        return input_t((state + (int32_t(1) << (FracBits - 1))) >> FracBits);
+    }
+
+    /// @copydoc    OneEuroFilter::filter(input_t)
+    input_t operator()(input_t input) { return filter(input); }
+
+    /// Set the minimum cut-off frequency @f$ f_{c,\min} @f$ in Hz, used when
+    /// the input is not moving. Lower values reduce the jitter, but increase
+    /// the lag of slow movements.
+    void setMinCutoff(float hz) { minCutoffCoef = frequencyCoef(hz); }
+    /// Set the speed coefficient @f$ \beta @f$ in Hz per (input unit per
+    /// second). Higher values reduce the lag of fast movements.
+    /// The coefficient is stored in 32-bit fixed point, so @f$ \beta @f$ is
+    /// clamped to @f$ [0, 128 / \pi] \approx [0, 40.7] @f$.
+    void setBeta(float beta) {
+        betaCoef = toCoef(TwoPi * beta * float(1ul << 24));
+    }
+    /// Set the cut-off frequency in Hz of the filter for the speed of the
+    /// input.
+    void setDerivativeCutoff(float hz) { dCutoffCoef = frequencyCoef(hz); }
+
+    /// Verify the input range to make sure it fits in the state of the filter.
+    template <class T>
+    constexpr static bool supports_range(T min, T max) {
+        return min <= max && min >= std::numeric_limits<input_t>::min() &&
+               max <= std::numeric_limits<input_t>::max() &&
+               int64_t(min) >= -MaxInput - 1 && int64_t(max) <= MaxInput;
+    }
+
+  private:
+    /// Convert a frequency to the coefficient for @ref omega.
+    static uint32_t frequencyCoef(float hz) {
+        // 2π f × 2³² × 10⁻⁶, so the result of omega has 16 fractional bits
+        return toCoef(TwoPi * hz * 4294.967296f);
+    }
+    /// Round a coefficient to an integer, clamping it to the range of
+    /// `uint32_t` (converting values outside of that range is undefined).
+    /// Negative coefficients and NaN result in zero.
+    static uint32_t toCoef(float coef) {
+        return !(coef > 0)             ? 0
+               : coef >= 4294967296.0f ? 0xFFFFFFFFul
+                                       : uint32_t(coef + 0.5f);
+    }
+    /// @f$ 2\pi f_c T @f$ with 16 fractional bits, for a sampling period of
+    /// `dt` microseconds.
+    static uint32_t omega(uint32_t coef, uint32_t dt) {
+        return uint32_t((uint64_t(coef) * dt) >> 16);
+    }
+    /// @f$ \frac{\omega}{1 + \omega} = 1 - \frac{1}{1 + \omega} @f$ with 16
+    /// fractional bits.
+    static uint32_t alpha(uint32_t w) {
+        if (w > MaxOmega)
+            w = MaxOmega;
+        return (uint32_t(1) << 16) - 0xFFFFFFFFul / ((uint32_t(1) << 16) + w);
+    }
+    /// Multiply by a coefficient with 16 fractional bits.
+    static int32_t mul(uint32_t alpha, int32_t x) {
+        return int32_t((int64_t(alpha) * x) / (int64_t(1) << 16));
+    }
+
+    constexpr static float TwoPi = 6.28318531f;
+    constexpr static uint8_t FracBits = 8;
+    /// Leaves room for the differences between the input, the state and
+    /// the speed.
+    constexpr static int32_t MaxInput = (int32_t(1) << (29 - FracBits)) - 1;
+    constexpr static uint32_t MaxDt = 0xFFFF;
+    constexpr static uint32_t MaxOmega = 0x7FFFFFFF;
+
+    int32_t state;
+    int32_t speed;
+    unsigned long lastTime;
+    uint32_t minCutoffCoef;
+    uint32_t betaCoef;
+    uint32_t dCutoffCoef;
+};
+
+END_AH_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
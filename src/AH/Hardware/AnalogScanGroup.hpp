@@ -0,0 +1,139 @@
+#pragma once
+
+#include <AH/Settings/Warnings.hpp>
+AH_DIAGNOSTIC_WERROR() // Enable errors on warnings
+
+#include <AH/Containers/Array.hpp>
+#include <AH/Hardware/ExtendedInputOutput/ExtendedIOElement.hpp>
+#include <AH/Settings/SettingsWrapper.hpp>
+
+BEGIN_AH_NAMESPACE
+
+/**
+ * @brief   Samples a group of analog inputs back-to-back, and stores the
+ *          results in one contiguous array.
+ *
+ * Without a scan group, every @ref FilteredAnalog reads its own pin when it's
+ * updated, with the update of the element (and the pin lookup) between two
+ * conversions. A scan group converts all of its channels right after each
+ * other, using `ExtIO::analogRead`, so all samples of a scan are taken close
+ * together in time. It doesn't make the conversions themselves any faster.
+ *
+ * The group is only scanned when it's needed: the samples are marked as stale
+ * at the start of every loop (in
+ * @ref ExtendedIOElement::updateAllBufferedInputs), and the first read of one
+ * of the inputs after that scans the entire group.
+ * The elements that read the group later in the same loop use the samples of
+ * that scan. If none of the elements are due (e.g. because of their update
+ * period, see @ref Updatable::setUpdatePeriod), the group isn't scanned at
+ * all.
+ *
+ * The group is an @ref ExtendedIOElement: element @f$ i @f$ of the group has
+ * the pin number `group.pin(i)`. Reading this pin using `ExtIO::analogRead`
+ * (e.g. by a @ref FilteredAnalog or a potentiometer that was created with
+ * that pin) returns the sample of the latest scan, it doesn't start a
+ * conversion of just that input.
+ *
+ * ```cpp
+ * AnalogScanGroup<4> pots {{A0, A1, A2, A3}};
+ * CCPotentiometer volume {pots.pin(0), {MIDI_CC::Channel_Volume, Channel_1}};
+ * CCPotentiometer pan {pots.pin(1), {MIDI_CC::Pan, Channel_1}};
+ * ```
+ *
+ * The channels can be native analog pins, or pins of other extended IO
+ * elements.
+ *
+ * @tparam  N
+ *          The number of analog inputs in the group.
+ *
+ * @ingroup AH_HardwareUtils
+ */
+template <uint16_t N>
+class AnalogScanGroup : public ExtendedIOElement {
+  public:
+    /**
+     * @brief   Create a scan group for the given analog inputs.
+     *
+     * @param   pins
+     *          The analog pins to sample, in scan order.
+     */
+    AnalogScanGroup(const Array<pin_t, N> &pins)
+        : ExtendedIOElement(N), pins(pins) {}
+
+    /// Sample all analog inputs once, so the first reads return valid data.
+    void begin() override { scan(); }
+
+    /// Sample all analog inputs now, back-to-back.
+    void scan() {
+        unsigned long start = micros();
+        for (uint16_t i = 0; i < N; ++i)
+            samples[i] = ExtIO::analogRead(pins[i]);
+        scanTime = micros() - start;
+        stale = false;
+    }
+
+    /// Mark the samples as stale, the group is scanned again when one of the
+    /// inputs is read.
+    void updateBufferedInputs() override { stale = true; }
+
+    /// Get the sample of the latest scan, scanning the group first if the
+    /// samples are stale. Unlike other extended IO elements, this doesn't
+    /// sample the input again if it was already scanned during this loop.
+    analog_t analogRead(pin_t pin) override { return analogReadBuffered(pin); }
+    /// @copydoc analogRead
+    analog_t analogReadBuffered(pin_t pin) override {
+        scanIfStale();
+        return samples[pin];
+    }
+
+    /// Compare the sample of the latest scan to half of the full range.
+    PinStatus_t digitalRead(pin_t pin) override {
+        return digitalReadBuffered(pin);
+    }
+    /// @copydoc digitalRead
+    PinStatus_t digitalReadBuffered(pin_t pin) override {
+        scanIfStale();
+        return samples[pin] >= (1u << (ADC_BITS - 1)) ? HIGH : LOW;
+    }
+
+    /// Set the pin mode of the underlying pin (e.g. to enable the pull-up
+    /// resistor).
+    void pinModeBuffered(pin_t pin, PinMode_t mode) override {
+        ExtIO::pinMode(pins[pin], mode);
+    }
+
+    /// The inputs can't be used as outputs, this has no effect.
+    void digitalWriteBuffered(pin_t, PinStatus_t) override {}
+    /// The inputs can't be used as outputs, this has no effect.
+    void analogWriteBuffered(pin_t, analog_t) override {}
+    /// The inputs can't be used as outputs, this has no effect.
+    void updateBufferedOutputs() override {}
+
+    /// Get the samples of the latest scan, in the order of the pins, scanning
+    /// the group first if the samples are stale.
+    const analog_t *getSamples() {
+        scanIfStale();
+        return samples;
+    }
+    /// Get the underlying pin of the given element.
+    pin_t getPin(pin_t pin) const { return pins[pin]; }
+    /// Get the time it took to sample all inputs during the latest scan, in
+    /// microseconds.
+    unsigned long getScanTime() const { return scanTime; }
+
+  private:
+    void scanIfStale() {
+        if (stale)
+            scan();
+    }
+
+  private:
+    Array<pin_t, N> pins;
+    analog_t samples[N] = {};
+    unsigned long scanTime = 0;
+    bool stale = true;
+};
+
+END_AH_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
@@ -5,8 +5,10 @@ AH_DIAGNOSTIC_WERROR() // Enable errors on warnings
 
 #include <AH/Filters/EMA.hpp>
 #include <AH/Filters/Hysteresis.hpp>
+#include <AH/Filters/OneEuro.hpp>
 #include <AH/Hardware/ExtendedInputOutput/ExtendedInputOutput.hpp>
 #include <AH/Hardware/Hardware-Types.hpp>
+#include <AH/Math/CurveLUT.hpp>
 #include <AH/Math/IncreaseBitDepth.hpp>
 #include <AH/Math/MinMaxFix.hpp>
 #ifdef __AVR__
@@ -40,7 +42,8 @@ template <class MappingFunction, uint8_t Precision = 10,
           uint8_t FilterShiftFactor = ANALOG_FILTER_SHIFT_FACTOR,
           class FilterType = ANALOG_FILTER_TYPE, class AnalogType = analog_t,
           uint8_t IncRes = MaximumFilteredAnalogIncRes<
-              FilterShiftFactor, FilterType, AnalogType>::value>
+              FilterShiftFactor, FilterType, AnalogType>::value,
+          class Filter = EMA<FilterShiftFactor, AnalogType, FilterType>>
 class GenericFilteredAnalog {
   public:
     /**
@@ -114,6 +117,16 @@ class GenericFilteredAnalog {
      */
     const MappingFunction &getMappingFunction() const { return mapFn; }
 
+    /**
+     * @brief   Get a reference to the filter, e.g. to tune the parameters of a
+     *          @ref OneEuroFilter.
+     */
+    Filter &getFilter() { return filter; }
+    /**
+     * @brief   Get a reference to the filter.
+     */
+    const Filter &getFilter() const { return filter; }
+
     /**
      * @brief   Read the analog input value, apply the mapping function, and
      *          update the average.
@@ -125,7 +138,7 @@ class GenericFilteredAnalog {
      */
     bool update() {
         AnalogType input = getRawValue(); // read the raw analog input value
-        input = filter.filter(input);     // apply a low-pass EMA filter
+        input = filter.filter(input);     // apply a low-pass filter
         input = mapFnHelper(input);       // apply the mapping function
         return hysteresis.update(input);  // apply hysteresis, and return true
         // if the value changed since last time
@@ -213,8 +226,6 @@ class GenericFilteredAnalog {
     pin_t analogPin;
     MappingFunction mapFn;
 
-    using EMA_t = EMA<FilterShiftFactor, AnalogType, FilterType>;
-
     static_assert(
         ADC_BITS + IncRes + FilterShiftFactor <= sizeof(FilterType) * CHAR_BIT,
         "Error: FilterType is not wide enough to hold the maximum value");
@@ -224,10 +235,10 @@ class GenericFilteredAnalog {
     static_assert(
         Precision <= ADC_BITS + IncRes,
         "Error: Precision is larger than the increased ADC precision");
-    static_assert(EMA_t::supports_range(AnalogType(0), getMaxRawValue()),
-                  "Error: EMA filter type doesn't support full ADC range");
+    static_assert(Filter::supports_range(AnalogType(0), getMaxRawValue()),
+                  "Error: filter type doesn't support full ADC range");
 
-    EMA_t filter;
+    Filter filter;
     Hysteresis<ADC_BITS + IncRes - Precision, AnalogType, AnalogType>
         hysteresis;
 };
@@ -237,8 +248,10 @@ class GenericFilteredAnalog {
  *
  * A map function can be applied to the analog value (e.g. to compensate for
  * logarithmic taper potentiometers or to calibrate the range). The analog input
- * value is filtered using an exponential moving average filter. The default
- * settings for this filter can be changed in Settings.hpp.  
+ * value is filtered using an exponential moving average filter, or using any
+ * other filter type, such as a @ref OneEuroFilter (see
+ * @ref OneEuroFilteredAnalog). The default settings for these filters can be
+ * changed in Settings.hpp.  
  * After filtering, hysteresis is applied to prevent flipping back and forth 
  * between two values when the input is not changing.
  * 
@@ -262,6 +275,8 @@ class GenericFilteredAnalog {
  * @tparam  IncRes
  *          The number of bits to increase the resolution of the analog reading
  *          by.
+ * @tparam  Filter
+ *          The low-pass filter, with the same interface as @ref EMA.
  * 
  * @ingroup AH_HardwareUtils
  */
@@ -269,11 +284,12 @@ template <uint8_t Precision = 10,
           uint8_t FilterShiftFactor = ANALOG_FILTER_SHIFT_FACTOR,
           class FilterType = ANALOG_FILTER_TYPE, class AnalogType = analog_t,
           uint8_t IncRes = MaximumFilteredAnalogIncRes<
-              FilterShiftFactor, FilterType, AnalogType>::value>
+              FilterShiftFactor, FilterType, AnalogType>::value,
+          class Filter = EMA<FilterShiftFactor, AnalogType, FilterType>>
 class FilteredAnalog
     : public GenericFilteredAnalog<AnalogType (*)(AnalogType), Precision,
                                    FilterShiftFactor, FilterType, AnalogType,
-                                   IncRes> {
+                                   IncRes, Filter> {
   public:
     /**
      * @brief   Construct a new FilteredAnalog object.
@@ -286,7 +302,7 @@ class FilteredAnalog
     FilteredAnalog(pin_t analogPin, AnalogType initial = 0)
         : GenericFilteredAnalog<AnalogType (*)(AnalogType), Precision,
                                 FilterShiftFactor, FilterType, AnalogType,
-                                IncRes>(analogPin, nullptr, initial) {}
+                                IncRes, Filter>(analogPin, nullptr, initial) {}
 
     /**
      * @brief   Construct a new FilteredAnalog object.
@@ -315,6 +331,105 @@ class FilteredAnalog
     }
 };
 
+/**
+ * @brief   A @ref FilteredAnalog that uses a @ref OneEuroFilter instead of an
+ *          EMA filter: the output is smoother when the input moves slowly, and
+ *          it lags less when the input moves fast.
+ *
+ * The input has the same resolution as with the default EMA filter. The
+ * parameters can be tuned using `getFilter()`.
+ *
+ * @ingroup AH_HardwareUtils
+ */
+template <uint8_t Precision = 10, class AnalogType = analog_t>
+using OneEuroFilteredAnalog = FilteredAnalog<
+    Precision, ANALOG_FILTER_SHIFT_FACTOR, ANALOG_FILTER_TYPE, AnalogType,
+    MaximumFilteredAnalogIncRes<ANALOG_FILTER_SHIFT_FACTOR, ANALOG_FILTER_TYPE,
+                                AnalogType>::value,
+    OneEuroFilter<AnalogType>>;
+
+/**
+ * @brief   A @ref CurveLUT whose input and output have the resolution of the
+ *          filtered values of a @ref FilteredAnalog with the default filter
+ *          settings.
+ *
+ * @tparam  IndexBits
+ *          The number of bits used to select a point of the table.
+ * @tparam  AnalogType
+ *          The type to use for the analog values.
+ */
+template <uint8_t IndexBits = 5, class AnalogType = analog_t>
+using FilteredAnalogCurve =
+    CurveLUT<ADC_BITS + MaximumFilteredAnalogIncRes<ANALOG_FILTER_SHIFT_FACTOR,
+                                                    ANALOG_FILTER_TYPE,
+                                                    AnalogType>::value,
+             ADC_BITS + MaximumFilteredAnalogIncRes<ANALOG_FILTER_SHIFT_FACTOR,
+                                                    ANALOG_FILTER_TYPE,
+                                                    AnalogType>::value,
+             IndexBits>;
+
+/**
+ * @brief   A @ref FilteredAnalog whose mapping function is a response curve
+ *          stored as a lookup table (@ref CurveLUT), e.g. to compensate for
+ *          logarithmic taper potentiometers.
+ *
+ * The element only stores a reference to the curve (see @ref CurveLUTRef),
+ * so all elements with the same response share a single table, which is kept
+ * in flash on AVR. The curve is applied without calling through a function
+ * pointer.
+ *
+ * ```cpp
+ * constexpr FilteredAnalogCurve<> volumeCurve PROGMEM =
+ *     FilteredAnalogCurve<>::antiLogarithmic();
+ * CurveFilteredAnalog<7> volume1 {A0, volumeCurve};
+ * CurveFilteredAnalog<7> volume2 {A1, volumeCurve};
+ * ```
+ *
+ * @tparam  Precision
+ *          The number of bits of precision the output should have.
+ * @tparam  IndexBits
+ *          The number of bits used to select a point of the curve's table,
+ *          see @ref CurveLUT.
+ * @tparam  AnalogType
+ *          The type to use for the analog values.
+ *
+ * @ingroup AH_HardwareUtils
+ */
+template <uint8_t Precision = 10, uint8_t IndexBits = 5,
+          class AnalogType = analog_t>
+class CurveFilteredAnalog
+    : public GenericFilteredAnalog<
+          CurveLUTRef<FilteredAnalogCurve<IndexBits, AnalogType>>, Precision,
+          ANALOG_FILTER_SHIFT_FACTOR, ANALOG_FILTER_TYPE, AnalogType> {
+  public:
+    /// The type of the response curve.
+    using Curve = FilteredAnalogCurve<IndexBits, AnalogType>;
+
+    /**
+     * @brief   Construct a new CurveFilteredAnalog object.
+     *
+     * @param   analogPin
+     *          The analog pin to read from.
+     * @param   curve
+     *          The response curve to apply after filtering. It isn't copied,
+     *          so it has to outlive this object, and on AVR, it has to be
+     *          stored in flash (`PROGMEM`).
+     * @param   initial
+     *          The initial value of the filter.
+     */
+    CurveFilteredAnalog(pin_t analogPin, const Curve &curve,
+                        AnalogType initial = 0)
+        : CurveFilteredAnalog::GenericFilteredAnalog(
+              analogPin, CurveLUTRef<Curve>(curve), initial) {}
+    /// Construct a new CurveFilteredAnalog object with a linear response,
+    /// without a table.
+    CurveFilteredAnalog(pin_t analogPin)
+        : CurveFilteredAnalog::GenericFilteredAnalog(
+              analogPin, CurveLUTRef<Curve>(), 0) {}
+    /// The curve isn't copied, so it can't be a temporary.
+    CurveFilteredAnalog(pin_t, const Curve &&, AnalogType = 0) = delete;
+};
+
 END_AH_NAMESPACE
 
 AH_DIAGNOSTIC_POP()
@@ -4,30 +4,74 @@
 #include <AH/Settings/Warnings.hpp>
 AH_DIAGNOSTIC_WERROR() // Enable errors on warnings
 
+#include <AH/Filters/OneEuro.hpp>
+#include <AH/Math/CurveLUT.hpp>
+#include <AH/Settings/SettingsWrapper.hpp>
+
 BEGIN_AH_NAMESPACE
 
+/**
+ * @brief The default filter for the raw readings of @ref FilteredTouch: an
+ * exponential moving average in fixed point (8 fractional bits, Q16
+ * coefficient).
+ */
+class FilteredTouchEMA {
+public:
+    /// Reset the filter to the given value
+    void reset(uint32_t value) { smooth = int32_t(value) << 8; }
+
+    /// Filter a new raw reading (at most 23 bits)
+    uint32_t filter(uint32_t raw) {
+        int32_t x = int32_t(raw) << 8;
+        smooth += int32_t((int64_t(SMOOTH_COEF) * (x - smooth)) >> 16);
+        return uint32_t(smooth + 128) >> 8;
+    }
+
+private:
+    #ifndef TOUCH_SMOOTH_COEF
+    constexpr static int32_t SMOOTH_COEF = 0.95f * 65536 + 0.5f; // Slower response to raw = smoother signal
+    #else
+    constexpr static int32_t SMOOTH_COEF = TOUCH_SMOOTH_COEF * 65536 + 0.5f;
+    #endif
+
+    int32_t smooth = 0;
+};
+
 #ifdef ESP32
 
 /**
- * @brief A class for filtering capacitive touch sensor readings using adaptive 
+ * @brief A class for filtering capacitive touch sensor readings using adaptive
  * baseline tracking with multi-stage smoothing.
- * 
+ *
+ * All filtering is done in fixed point: the states have 8 fractional bits,
+ * the coefficients and the normalized touch level have 16 (Q16). The response
+ * curve is a @ref CurveLUT, see @ref setCurveExponent.
+ *
+ * Computing a new value and reading it are separate steps: @ref update reads
+ * the sensor and advances the filters (at most once per sample period),
+ * @ref getValue just returns the result, it can be called any number of
+ * times.
+ *
  * @tparam Precision The precision of the output value (bit depth)
+ * @tparam Filter The filter for the raw readings, e.g.
+ *         `OneEuroFilter<uint32_t>` to smooth slow movements more without
+ *         adding lag to fast ones. It should have `reset(value)` and
+ *         `filter(value)` methods, like @ref FilteredTouchEMA.
  */
-template <uint8_t Precision = 7>
+template <uint8_t Precision = 7, class Filter = FilteredTouchEMA>
 class FilteredTouch {
+    static_assert(Precision <= 14, "Precision too high for the Q16 output");
+
 public:
     /// Constructor
-    FilteredTouch(int touchPin) : touchPin(touchPin) {}
+    FilteredTouch(int touchPin) : touchPin(touchPin) {
+        setCurveExponent(CURVE_EXPONENT);
+    }
 
     /// Initialize the touch sensor
     void begin() {
-        raw = touchRead(touchPin);
-        smooth = raw;
-        baseline = raw;
-        mappedSmooth = 0;
-        mappedValue = 0;
-        lastUpdateTime = 0;
+        resetFilters(touchRead(touchPin));
+        lastSampleTime = micros() - samplePeriod;
         initialized = true;
     }
 
@@ -35,149 +79,187 @@ public:
     void resetToCurrentValue() {
         if (!initialized)
             begin();
-        raw = touchRead(touchPin);
-        smooth = raw;
-        baseline = raw;
-        mappedSmooth = 0;
-        mappedValue = 0;
+        resetFilters(touchRead(touchPin));
     }
 
     /**
-     * @brief Update the raw touch value if enough time has passed
-     * 
-     * @return true if the value changed and was updated, false otherwise
+     * @brief Read the sensor and compute a new value, if the sample period
+     *        has passed since the previous sample.
+     *
+     * @return true if the value changed, false otherwise
      */
     bool update() {
         if (!initialized)
             begin();
 
-        // Check if enough time has passed since the last update
-        unsigned long currentTime = millis();
-        if (currentTime - lastUpdateTime < updateInterval) {
-            return false; // Not enough time has passed
-        }
-        
-        // Store the last update time
-        lastUpdateTime = currentTime;
-        
-        int oldValue = mappedValue;
-        
-        // Read the raw touch value
+        // Check if enough time has passed since the last sample
+        unsigned long now = micros();
+        if (now - lastSampleTime < samplePeriod)
+            return false;
+        lastSampleTime = now;
+
+        uint16_t oldValue = mappedValue;
         raw = touchRead(touchPin);
-        
-        return oldValue != getValue();
+        compute();
+        return oldValue != mappedValue;
     }
 
-    /// Get the current filtered value - calculations happen here
-    int getValue() {
+    /// Get the filtered value that was computed by the last @ref update
+    uint16_t getValue() const { return mappedValue; }
+
+    /// Get the raw touch value of the last sample
+    uint32_t getRawValue() const { return raw; }
+
+    /// Set the time between two samples in microseconds. Zero samples the
+    /// sensor on every update.
+    void setSamplePeriod(unsigned long period) { samplePeriod = period; }
+    /// Get the time between two samples in microseconds
+    unsigned long getSamplePeriod() const { return samplePeriod; }
+
+    /// Set the time between two samples in milliseconds
+    void setUpdateInterval(unsigned long interval) {
+        setSamplePeriod(interval * 1000ul);
+    }
+
+    /**
+     * @brief Set the response curve: the normalized touch level is raised to
+     *        the given power. Values above one make the response less
+     *        sensitive for light touches.
+     *
+     * The curve is sampled into a lookup table, so the exponent is only used
+     * here, not for every sample.
+     */
+    void setCurveExponent(float exponent) {
+        curve.generate([exponent](double x) {
+            return exponent == 1.0f ? x : powf(float(x), exponent);
+        });
+    }
+
+    /// Get the filter for the raw readings, e.g. to tune its parameters
+    Filter &getFilter() { return rawFilter; }
+
+private:
+    void resetFilters(uint32_t value) {
+        raw = value;
+        rawFilter.reset(value);
+        baseline = int32_t(value) << 8;
+        mappedSmooth = 0;
+        mappedValue = 0;
+    }
+
+    /// Advance the filters with the latest raw reading
+    void compute() {
         // 1. Smoothing
-        smooth = smooth * (1.0f - SMOOTH_COEF) + raw * SMOOTH_COEF;
-        
-        // 2. Delta calculation
-        delta = smooth - baseline;
-        if (delta < 0) delta = 0; // Clamp to 0
-        
+        int32_t smooth = int32_t(rawFilter.filter(raw)) << 8;
+
+        // 2. Delta calculation, clamped to 0
+        int32_t delta = smooth > baseline ? smooth - baseline : 0;
+
         // 3. Freeze baseline when hand is detected
-        if (delta < baselineThreshold) { // Only update baseline when hand is far
-            baseline = baseline * (1.0f - BASELINE_COEF) + smooth * BASELINE_COEF;
-        }
-        
-        // 4. Normalize and curve delta
-        float normDelta = constrain(delta / DELTA_MAX, 0.0f, 1.0f);
-        float curvedDelta = pow(normDelta, 1.0f); // Exponential sensitivity
-        
-        // 5. Map to output range and smooth
-        // Use the template parameter to determine the maximum output value
-        float maxValue = (1 << Precision) - 1;
-        float mappedRaw = curvedDelta * maxValue;
-        mappedSmooth = mappedSmooth * (1.0f - MAPPED_SMOOTH_COEF) + mappedRaw * MAPPED_SMOOTH_COEF;
-        mappedValue = round(mappedSmooth);
-        
+        if (delta < BASELINE_THRESHOLD) // Only update baseline when hand is far
+            baseline += mulQ16(BASELINE_COEF, smooth - baseline);
+
+        // 4. Normalize (Q16) and curve delta
+        uint32_t norm = uint32_t((uint64_t(delta) * DELTA_MAX_RECIP) >> 24);
+        if (norm > 0xFFFF)
+            norm = 0xFFFF;
+        uint32_t curved = curve(uint16_t(norm));
+
+        // 5. Map to output range (Q16) and smooth
+        int32_t mappedRaw = int32_t(curved * MaxValue);
+        mappedSmooth += mulQ16(MAPPED_SMOOTH_COEF, mappedRaw - mappedSmooth);
+        mappedValue = uint32_t(mappedSmooth + 0x8000) >> 16;
+
         #ifdef DEBUG_TOUCH
         Serial.print("Raw: "); Serial.print(raw);
-        Serial.print("\tSmooth: "); Serial.print(smooth);
-        Serial.print("\tBaseline: "); Serial.print(baseline);
-        Serial.print("\tDelta: "); Serial.print(delta);
+        Serial.print("\tSmooth: "); Serial.print(smooth >> 8);
+        Serial.print("\tBaseline: "); Serial.print(baseline >> 8);
+        Serial.print("\tDelta: "); Serial.print(delta >> 8);
         Serial.print("\tMapped: "); Serial.println(mappedValue);
         #endif
-        
-        return mappedValue;
     }
 
-    /// Get the raw touch value
-    float getRawValue() const {
-        return raw;
-    }
-    
-    /// Set the update interval in milliseconds
-    void setUpdateInterval(unsigned long interval) {
-        updateInterval = interval;
+    /// Multiply by a Q16 coefficient
+    static int32_t mulQ16(int32_t coef, int32_t x) {
+        return int32_t((int64_t(coef) * x) >> 16);
     }
 
 private:
     int touchPin;
     bool initialized = false;
-    unsigned long lastUpdateTime = 0;
-    
+    unsigned long lastSampleTime = 0;
+
     // Use defined values if available, otherwise use defaults
     #ifndef TOUCH_UPDATE_INTERVAL
-    unsigned long updateInterval = 50; // Default 50ms between updates (like delay(50))
+    unsigned long samplePeriod = TOUCH_SAMPLE_PERIOD;
     #else
-    unsigned long updateInterval = TOUCH_UPDATE_INTERVAL;
+    unsigned long samplePeriod = TOUCH_UPDATE_INTERVAL * 1000ul;
     #endif
 
-    // Configurable Parameters
-    #ifndef TOUCH_SMOOTH_COEF
-    const float SMOOTH_COEF = 0.95f;       // Slower response to raw = smoother signal
-    #else
-    const float SMOOTH_COEF = TOUCH_SMOOTH_COEF;
-    #endif
-    
+    Filter rawFilter;
+
+    // Configurable Parameters, converted to fixed point
     #ifndef TOUCH_BASELINE_COEF
-    const float BASELINE_COEF = 0.01f;     // Baseline tracking speed
+    constexpr static int32_t BASELINE_COEF = 0.01f * 65536 + 0.5f; // Baseline tracking speed
     #else
-    const float BASELINE_COEF = TOUCH_BASELINE_COEF;
+    constexpr static int32_t BASELINE_COEF = TOUCH_BASELINE_COEF * 65536 + 0.5f;
     #endif
-    
+
     #ifndef TOUCH_DELTA_MAX
-    const float DELTA_MAX = 4000.0f;       // Maximum expected delta value
+    constexpr static float DELTA_MAX = 4000.0f; // Maximum expected delta value
     #else
-    const float DELTA_MAX = TOUCH_DELTA_MAX;
+    constexpr static float DELTA_MAX = TOUCH_DELTA_MAX;
     #endif
-    
+    /// 2³² / DELTA_MAX: normalizes a delta with 8 fractional bits to Q16
+    /// after shifting right by 24 bits
+    constexpr static uint32_t DELTA_MAX_RECIP = 4294967296.0f / DELTA_MAX;
+
     #ifndef TOUCH_MAPPED_SMOOTH_COEF
-    const float MAPPED_SMOOTH_COEF = 0.2f; // Smoothing for the final mapped output
+    constexpr static int32_t MAPPED_SMOOTH_COEF = 0.2f * 65536 + 0.5f; // Smoothing for the final mapped output
     #else
-    const float MAPPED_SMOOTH_COEF = TOUCH_MAPPED_SMOOTH_COEF;
+    constexpr static int32_t MAPPED_SMOOTH_COEF = TOUCH_MAPPED_SMOOTH_COEF * 65536 + 0.5f;
     #endif
-    
+
     #ifndef TOUCH_BASELINE_THRESHOLD
-    float baselineThreshold = 100.0f; // Threshold for freezing baseline updates
+    constexpr static int32_t BASELINE_THRESHOLD = 100.0f * 256; // Threshold for freezing baseline updates
     #else
-    float baselineThreshold = TOUCH_BASELINE_THRESHOLD;
+    constexpr static int32_t BASELINE_THRESHOLD = TOUCH_BASELINE_THRESHOLD * 256;
     #endif
 
+    #ifndef TOUCH_CURVE_EXPONENT
+    constexpr static float CURVE_EXPONENT = 1.0f; // Exponential sensitivity
+    #else
+    constexpr static float CURVE_EXPONENT = TOUCH_CURVE_EXPONENT;
+    #endif
+
+    constexpr static uint32_t MaxValue = (1ul << Precision) - 1;
+
     // Runtime Variables
-    float raw = 0;
-    float smooth = 0;
-    float baseline = 0;
-    float delta = 0;
-    float mappedSmooth = 0;
-    int mappedValue = 0;
+    uint32_t raw = 0;
+    int32_t baseline = 0;     // 8 fractional bits
+    int32_t mappedSmooth = 0; // Q16
+    uint16_t mappedValue = 0;
+    CurveLUT<16, 16, 4> curve; // Q16, 17 points
 };
 
 #else
 // Empty class for non-ESP32 platforms to avoid compilation errors
-template <uint8_t Precision = 7>
+template <uint8_t Precision = 7, class Filter = FilteredTouchEMA>
 class FilteredTouch {
 public:
     FilteredTouch(int) {}
     void begin() {}
     void resetToCurrentValue() {}
     bool update() { return false; }
-    int getValue() { return 0; }
-    float getRawValue() const { return 0; }
+    uint16_t getValue() const { return 0; }
+    uint32_t getRawValue() const { return 0; }
+    void setSamplePeriod(unsigned long) {}
+    unsigned long getSamplePeriod() const { return 0; }
     void setUpdateInterval(unsigned long) {}
+    void setCurveExponent(float) {}
+    Filter &getFilter() { return rawFilter; }
+private:
+    Filter rawFilter;
 };
 #endif // ESP32
 
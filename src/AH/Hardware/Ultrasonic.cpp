@@ -0,0 +1,124 @@
+#include "Ultrasonic.hpp"
+
+BEGIN_AH_NAMESPACE
+
+static_assert(ULTRASONIC_MAX_INTERRUPTS > 0 && ULTRASONIC_MAX_INTERRUPTS <= 8,
+              "ULTRASONIC_MAX_INTERRUPTS should be between 1 and 8");
+
+Ultrasonic *Ultrasonic::instances[ULTRASONIC_MAX_INTERRUPTS] = {};
+
+template <uint8_t I>
+void Ultrasonic::isr() {
+    Ultrasonic *u = instances[I % ULTRASONIC_MAX_INTERRUPTS];
+    if (u != nullptr)
+        u->onEdge(digitalRead(u->_pin), micros());
+}
+
+void (*const Ultrasonic::isrs[8])() = {
+    isr<0>, isr<1>, isr<2>, isr<3>, isr<4>, isr<5>, isr<6>, isr<7>,
+};
+
+Ultrasonic::~Ultrasonic() {
+    if (_slot == NoSlot || instances[_slot] != this)
+        return;
+#ifdef digitalPinToInterrupt
+    detachInterrupt(digitalPinToInterrupt(_pin));
+#endif
+    instances[_slot] = nullptr;
+}
+
+void Ultrasonic::begin() {
+    pinMode(_pin, OUTPUT);
+    digitalWrite(_pin, LOW);
+    _state = Idle;
+    // Trigger on the first update
+    _triggerTime = micros() - _interval;
+#ifdef digitalPinToInterrupt
+    if (_slot != NoSlot || _pin >= NUM_DIGITAL_PINS)
+        return;
+#ifdef NOT_AN_INTERRUPT
+    if (digitalPinToInterrupt(_pin) == NOT_AN_INTERRUPT)
+        return;
+#endif
+    for (uint8_t slot = 0; slot < ULTRASONIC_MAX_INTERRUPTS; ++slot) {
+        if (instances[slot] == nullptr) {
+            instances[slot] = this;
+            _slot = slot;
+            attachInterrupt(digitalPinToInterrupt(_pin), isrs[slot], CHANGE);
+            return;
+        }
+    }
+#endif
+}
+
+void Ultrasonic::trigger() {
+    _state = Triggering;
+    pinMode(_pin, OUTPUT);
+    digitalWrite(_pin, LOW);
+    delayMicroseconds(2);
+    digitalWrite(_pin, HIGH);
+    delayMicroseconds(10);
+    digitalWrite(_pin, LOW);
+    pinMode(_pin, INPUT);
+    _triggerTime = micros();
+    _state = WaitingForEcho;
+}
+
+void Ultrasonic::onEdge(bool level, unsigned long now) {
+    if (_state == WaitingForEcho && level) {
+        _echoStart = now;
+        _state = Echo;
+    } else if (_state == Echo && !level) {
+        _echoDuration = now - _echoStart;
+        _state = Done;
+    }
+}
+
+bool Ultrasonic::startMeasurement() {
+    if (_state != Idle)
+        return false;
+    trigger();
+    return true;
+}
+
+void Ultrasonic::poll() {
+    unsigned long now = micros();
+    if (_slot == NoSlot)
+        onEdge(digitalRead(_pin), now);
+
+    switch (_state) {
+        case Idle:
+            if (_autoTrigger && now - _triggerTime >= _interval)
+                trigger();
+            break;
+        case Done: {
+            // The ISR doesn't touch the duration until the next trigger
+            unsigned long duration = _echoDuration;
+            _state = Idle;
+            uint16_t distance = duration * 343ul / 2000; // Convert to mm
+            if (distance > 0 && distance < 4000) { // Filter out extreme values
+                _lastValidDistance = distance; // Save as last valid reading
+                _measurementTime = _triggerTime;
+                _newMeasurement = true;
+            }
+            break;
+        }
+        default:
+            if (now - _triggerTime >= ULTRASONIC_ECHO_TIMEOUT) {
+                noInterrupts();
+                if (_state != Done)
+                    _state = Idle; // No echo, keep the last good reading
+                interrupts();
+            }
+            break;
+    }
+}
+
+bool Ultrasonic::update() {
+    poll();
+    bool newMeasurement = _newMeasurement;
+    _newMeasurement = false;
+    return newMeasurement;
+}
+
+END_AH_NAMESPACE
@@ -1,6 +1,9 @@
 #pragma once
 
-#include "AH/Settings/NamespaceSettings.hpp"
+#include <AH/Hardware/Hardware-Types.hpp>
+#include <AH/Settings/SettingsWrapper.hpp>
+
+#include <AH/Arduino-Wrapper.h> // pin functions, micros, attachInterrupt
 
 BEGIN_AH_NAMESPACE
 
@@ -9,50 +12,119 @@ BEGIN_AH_NAMESPACE
  *
  * This class interfaces with an ultrasonic distance sensor using a single digital pin.
  * It measures the pulse duration and converts it to distance in millimeters.
+ *
+ * Measuring is done without blocking: @ref update() triggers the sensor at a
+ * fixed interval, and the echo pulse is timed using a pin change interrupt.
+ * If the pin has no interrupt, or if all @ref ULTRASONIC_MAX_INTERRUPTS
+ * interrupt slots are in use, the echo pin is polled in @ref update() instead,
+ * so the resolution of the measurement depends on how often it is called.
+ *
+ * Sensors that are part of an @ref UltrasonicScheduler don't trigger
+ * themselves, the scheduler starts their measurements instead.
  */
 class Ultrasonic {
 public:
     /**
      * @brief Constructor to initialize the ultrasonic sensor.
      * @param pin The digital pin connected to the sensor.
+     * @param interval The time between two triggers, in microseconds.
      */
-    Ultrasonic(pin_t pin) : _pin(pin), _lastValidDistance(0) {}
+    Ultrasonic(pin_t pin, unsigned long interval = ULTRASONIC_TRIGGER_INTERVAL)
+        : _pin(pin), _interval(interval) {}
+
+    /// Releases the interrupt used by this sensor.
+    ~Ultrasonic();
 
     /**
-     * @brief Initializes the sensor pin.
+     * @brief Initializes the sensor pin and attaches the echo interrupt.
      */
-    void begin() {
-        pinMode(_pin, OUTPUT);
-    }
+    void begin();
+
+    /**
+     * @brief Triggers a new measurement when the interval has elapsed, and
+     *        checks whether the current one has finished. Never blocks longer
+     *        than the trigger pulse (12 µs).
+     * @retval true  A new valid measurement is available.
+     * @retval false No new measurement yet, or the echo timed out.
+     */
+    bool update();
+
+    /**
+     * @brief Advances the state machine like @ref update(), without
+     *        consuming the "new measurement" flag.
+     */
+    void poll();
 
     /**
-     * @brief Reads the distance from the sensor.
+     * @brief Starts a new measurement right away.
+     * @retval false The previous measurement is still in progress.
+     */
+    bool startMeasurement();
+
+    /**
+     * @brief Returns the last valid distance, without measuring.
+     * @return Distance in millimeters (mm).
+     */
+    uint16_t getDistanceMM() const { return _lastValidDistance; }
+
+    /**
+     * @brief Updates the sensor and returns the last valid distance.
      * @return Distance in millimeters (mm).
+     * @see update
      */
     uint16_t readDistanceMM() {
-        digitalWrite(_pin, LOW);
-        delayMicroseconds(2);
-        digitalWrite(_pin, HIGH);
-        delayMicroseconds(10);
-        digitalWrite(_pin, LOW);
+        update();
+        return getDistanceMM();
+    }
 
-        long duration = pulseIn(_pin, HIGH, 30000); // Get pulse duration
+    /// Set the time between two triggers, in microseconds.
+    void setInterval(unsigned long interval) { _interval = interval; }
+    /// Get the time between two triggers, in microseconds.
+    unsigned long getInterval() const { return _interval; }
 
-        if (duration == 0) {
-            return _lastValidDistance; // Return last good reading instead of 0
-        }
-        uint16_t distance = (duration / 2) * 0.343; // Convert to mm
+    /// Check whether the echo of the last trigger is still being waited for.
+    bool isMeasuring() const { return _state != Idle; }
 
-        if (distance > 0 && distance < 4000){ // Filter out extreme values{
-            _lastValidDistance = distance; // Save as last valid reading
-        }
+    /// Enable or disable triggering the sensor from @ref update(). When
+    /// disabled, measurements have to be started using
+    /// @ref startMeasurement().
+    void setAutoTrigger(bool autoTrigger) { _autoTrigger = autoTrigger; }
 
-        return _lastValidDistance;
-    }
+    /// Get the time the last valid measurement was triggered, in microseconds,
+    /// as returned by `micros()`.
+    unsigned long getMeasurementTime() const { return _measurementTime; }
 
 private:
+    enum State : uint8_t {
+        Idle,           ///< Waiting for the next trigger.
+        Triggering,     ///< Sending the trigger pulse, ignore the pin.
+        WaitingForEcho, ///< Trigger sent, waiting for the rising edge.
+        Echo,           ///< Rising edge seen, waiting for the falling edge.
+        Done,           ///< Falling edge seen, duration is available.
+    };
+
+    /// Send the trigger pulse and start waiting for the echo.
+    void trigger();
+    /// Advance the state machine for the given level of the echo pin.
+    void onEdge(bool level, unsigned long now);
+
+    template <uint8_t I>
+    static void isr();
+    constexpr static uint8_t NoSlot = 0xFF;
+    static Ultrasonic *instances[ULTRASONIC_MAX_INTERRUPTS];
+    static void (*const isrs[8])();
+
     pin_t _pin;                  ///< Digital pin connected to the sensor.
-    uint16_t _lastValidDistance; ///< Stores the last valid distance to avoid zero readings.
+    unsigned long _interval;     ///< Time between two triggers (µs).
+    unsigned long _triggerTime = 0; ///< Time of the last trigger (µs).
+    volatile unsigned long _echoStart = 0;    ///< Time of the rising edge.
+    volatile unsigned long _echoDuration = 0; ///< Length of the echo pulse.
+    volatile State _state = Idle;
+    uint8_t _slot = NoSlot;      ///< Interrupt slot, or NoSlot when polling.
+    uint16_t _lastValidDistance = 0; ///< Stores the last valid distance to avoid zero readings.
+    unsigned long _measurementTime = 0; ///< Trigger time of that distance.
+    bool _autoTrigger = true;    ///< Trigger from update() every interval.
+    bool _newMeasurement = false; ///< Set by poll(), cleared by update().
 };
 
 END_AH_NAMESPACE
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <AH/Containers/Array.hpp>
+#include <AH/Containers/Updatable.hpp>
+#include <AH/Hardware/Ultrasonic.hpp>
+
+BEGIN_AH_NAMESPACE
+
+/**
+ * @brief   Fires a group of ultrasonic sensors one at a time, so they don't
+ *          pick up each other's echoes.
+ *
+ * The sensors are triggered in a fixed (configurable) order. After a sensor
+ * has received its echo, or timed out, the scheduler waits for a guard
+ * interval before triggering the next one. Sensors without an echo don't have
+ * to wait for their full trigger interval, so the total update rate scales
+ * with the number of sensors.
+ *
+ * The results are still read from the sensors themselves (e.g. by the
+ * ultrasonic MIDI senders), the scheduler only decides when they are
+ * triggered. It is updated automatically together with the other
+ * @ref Updatable%s.
+ *
+ * @tparam  N
+ *          The number of sensors in the group.
+ */
+template <uint8_t N>
+class UltrasonicScheduler : public Updatable<> {
+  public:
+    /**
+     * @brief   Create a scheduler for the given sensors.
+     *
+     * @param   sensors
+     *          The sensors to trigger, e.g. `&sender.getUltrasonic()`.
+     * @param   guard
+     *          The time between the end of one measurement and the start of
+     *          the next, in microseconds.
+     */
+    UltrasonicScheduler(const Array<Ultrasonic *, N> &sensors,
+                        unsigned long guard = ULTRASONIC_GUARD_INTERVAL)
+        : sensors(sensors), guard(guard) {
+        for (uint8_t i = 0; i < N; ++i)
+            order[i] = i;
+    }
+
+    /// Disable the sensors' own triggering, and initialize them.
+    void begin() override {
+        for (Ultrasonic *sensor : sensors) {
+            sensor->setAutoTrigger(false);
+            sensor->begin();
+        }
+        current = N - 1;
+        // Start the first sensor on the first update
+        guardStart = micros() - guard;
+        cycleStart = guardStart;
+        measuring = false;
+    }
+
+    /// Wait for the current sensor, and trigger the next one after the guard
+    /// interval.
+    void update() override {
+        Ultrasonic &sensor = *sensors[order[current]];
+        if (measuring) {
+            sensor.poll();
+            if (sensor.isMeasuring())
+                return;
+            measuring = false;
+            guardStart = micros();
+        }
+        unsigned long now = micros();
+        if (now - guardStart < guard)
+            return;
+        if (++current == N) {
+            current = 0;
+            cycleTime = now - cycleStart;
+            cycleStart = now;
+        }
+        measuring = sensors[order[current]]->startMeasurement();
+        if (!measuring) // still busy, try again after another guard interval
+            guardStart = now;
+    }
+
+    /**
+     * @brief   Set the order in which the sensors are triggered.
+     *
+     * For example, `{0, 2, 1, 3}` keeps neighboring sensors apart. Every
+     * sensor index should appear exactly once.
+     */
+    void setOrder(const Array<uint8_t, N> &order) { this->order = order; }
+    /// Set the guard interval between two measurements, in microseconds.
+    void setGuardInterval(unsigned long guard) { this->guard = guard; }
+
+    /// Get the sensor with the given index.
+    Ultrasonic &getSensor(uint8_t index) { return *sensors[index]; }
+    /// Get the last valid distance of the given sensor, in millimeters.
+    uint16_t getDistanceMM(uint8_t index) const {
+        return sensors[index]->getDistanceMM();
+    }
+    /// Get the time the last valid distance of the given sensor was measured,
+    /// in microseconds.
+    unsigned long getMeasurementTime(uint8_t index) const {
+        return sensors[index]->getMeasurementTime();
+    }
+    /// Get the time it took to trigger all sensors once, in microseconds.
+    unsigned long getCycleTime() const { return cycleTime; }
+
+  private:
+    Array<Ultrasonic *, N> sensors;
+    Array<uint8_t, N> order;
+    unsigned long guard;
+    unsigned long guardStart = 0;
+    unsigned long cycleStart = 0;
+    unsigned long cycleTime = 0;
+    uint8_t current = N - 1;
+    bool measuring = false;
+};
+
+END_AH_NAMESPACE
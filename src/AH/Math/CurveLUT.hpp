@@ -0,0 +1,437 @@
+#pragma once
+
+#include <AH/Settings/Warnings.hpp>
+AH_DIAGNOSTIC_WERROR() // Enable errors on warnings
+
+#include <AH/Settings/NamespaceSettings.hpp>
+#include <stdint.h>
+#ifdef __AVR__
+#include <AH/STL/type_traits>
+#include <avr/pgmspace.h>
+#else
+#include <type_traits> // STL std::conditional
+#endif
+
+BEGIN_AH_NAMESPACE
+
+/// @addtogroup    AH_Math
+/// @{
+
+namespace detail {
+
+// The helpers below are written as single return statements, so they can be
+// evaluated at compile time in C++11 as well.
+
+constexpr double CurveLn2 = 0.69314718055994531;
+
+/// @f$ 2 \sum z^n / n @f$ for odd @f$ n @f$, up to @f$ n = 39 @f$.
+constexpr double curveAtanhSeries(double z, double z2, double term, int n) {
+    return n >= 40 ? 0 : term / n + curveAtanhSeries(z, z2, term * z2, n + 2);
+}
+
+/// Natural logarithm that can be evaluated at compile time, for generating
+/// the tables of @ref CurveLUT. `x` must be positive.
+constexpr double curveLog(double x) {
+    // ln(x) = 2 atanh((x - 1) / (x + 1)), with |z| <= 1/3 for x in [1, 2]
+    return x > 2   ? curveLog(x / 2) + CurveLn2
+           : x < 1 ? curveLog(x * 2) - CurveLn2
+                   : 2 * curveAtanhSeries((x - 1) / (x + 1),
+                                          (x - 1) * (x - 1) / (x + 1) / (x + 1),
+                                          (x - 1) / (x + 1), 1);
+}
+
+/// @f$ \sum x^n / n! @f$ for @f$ n \ge n_0 @f$, up to @f$ n = 15 @f$.
+constexpr double curveExpSeries(double x, double term, int n) {
+    return n >= 16 ? 0 : term + curveExpSeries(x, term * x / (n + 1), n + 1);
+}
+
+/// Square a number.
+constexpr double curveSquare(double x) { return x * x; }
+
+/// Exponential function that can be evaluated at compile time, for
+/// generating the tables of @ref CurveLUT.
+constexpr double curveExp(double x) {
+    // Halve the argument until the series converges quickly, then square
+    return x > 0.5 || x < -0.5 ? curveSquare(curveExp(x / 2))
+                               : curveExpSeries(x, 1, 0);
+}
+
+/// Integer power that can be evaluated at compile time.
+constexpr double curvePow(double x, uint8_t n) {
+    return n == 0 ? 1 : x * curvePow(x, n - 1);
+}
+
+/// List of indices of the points of a @ref CurveLUT.
+template <uint16_t... Is>
+struct CurveIndices {};
+
+template <class A, class B>
+struct CurveIndicesConcat;
+template <uint16_t... A, uint16_t... B>
+struct CurveIndicesConcat<CurveIndices<A...>, CurveIndices<B...>> {
+    using type = CurveIndices<A..., (sizeof...(A) + B)...>;
+};
+
+/// Generates `CurveIndices<0, 1, ..., N - 1>` (with a recursion depth of
+/// @f$ \log_2 N @f$).
+template <uint16_t N>
+struct MakeCurveIndices {
+    using type = typename CurveIndicesConcat<
+        typename MakeCurveIndices<N / 2>::type,
+        typename MakeCurveIndices<N - N / 2>::type>::type;
+};
+template <>
+struct MakeCurveIndices<0> {
+    using type = CurveIndices<>;
+};
+template <>
+struct MakeCurveIndices<1> {
+    using type = CurveIndices<0>;
+};
+
+} // namespace detail
+
+/**
+ * @brief   Response curve that is stored as a lookup table, for mapping the
+ *          values of a @ref GenericFilteredAnalog (e.g. to compensate for
+ *          logarithmic taper potentiometers, or to apply a calibration).
+ *
+ * The table has @f$ 2^\text{IndexBits} + 1 @f$ points, evenly spaced across
+ * the input range, and the values in between are interpolated linearly. The
+ * input is split into the index of the point (the `IndexBits` most
+ * significant bits) and the position between the two points (the remaining
+ * bits), so evaluating the curve only takes a lookup and an interpolation.
+ * If `IndexBits` equals `InBits`, the table contains every output value, and
+ * there is no interpolation.
+ *
+ * Tables can be generated at compile time, using one of the built-in curves
+ * or any function object with a `constexpr` call operator:
+ *
+ * ```cpp
+ * constexpr auto audioTaper = CurveLUT<14>::antiLogarithmic();
+ * ```
+ *
+ * They can also be generated (or adjusted) at run time, e.g. after a
+ * calibration, using @ref generate or @ref setPoint.
+ *
+ * The curve is a function object, so it can be used as the mapping function
+ * of a @ref GenericFilteredAnalog. Because its type is known at compile time,
+ * the mapping is inlined instead of being called through a function pointer.
+ * To share one table between multiple elements, use a @ref CurveLUTRef to a
+ * curve that is stored in flash (see @ref CurveFilteredAnalog).
+ *
+ * @tparam  InBits
+ *          The number of bits of the input values.
+ * @tparam  OutBits
+ *          The number of bits of the output values.
+ * @tparam  IndexBits
+ *          The number of bits used to select a point of the table:
+ *          the table has @f$ 2^\text{IndexBits} + 1 @f$ points.
+ */
+template <uint8_t InBits, uint8_t OutBits = InBits, uint8_t IndexBits = 5>
+class CurveLUT {
+    static_assert(InBits <= 16 && OutBits <= 16,
+                  "Error: only inputs and outputs up to 16 bits are supported");
+    static_assert(IndexBits <= InBits,
+                  "Error: the table is larger than the input range");
+
+  public:
+    /// The type of the points of the table: wide enough to hold
+    /// @f$ 2^\text{OutBits} @f$, the output value for an input of 1.0.
+    using entry_t =
+        typename std::conditional<(OutBits < 16), uint16_t, uint32_t>::type;
+
+    /// The number of points of the table.
+    constexpr static uint16_t NumPoints = (1u << IndexBits) + 1;
+    /// The maximum input value.
+    constexpr static uint16_t MaxIn = (1ul << InBits) - 1;
+    /// The maximum output value.
+    constexpr static uint16_t MaxOut = (1ul << OutBits) - 1;
+
+    /// Create a linear curve: the output is equal to the input (scaled to
+    /// the output range).
+    constexpr CurveLUT() : CurveLUT(Linear(), Indices()) {}
+
+    /**
+     * @brief   Create a curve by sampling the given function.
+     *
+     * @param   f
+     *          Function object that maps the input, a number from 0.0 to 1.0,
+     *          to an output from 0.0 to 1.0. Its call operator should be
+     *          `constexpr` to generate the table at compile time (in C++11,
+     *          this means it must consist of a single return statement).
+     */
+    template <class Function>
+    constexpr static CurveLUT fromFunction(Function f) {
+        return CurveLUT(f, Indices());
+    }
+
+    /**
+     * @brief   Fill the table by sampling the given function, at run time.
+     *
+     * Point @f$ i @f$ is @f$ f\left(i / 2^\text{IndexBits}\right) @f$, outputs
+     * outside of [0.0, 1.0] are clamped.
+     *
+     * @param   f
+     *          Function object that maps the input, a number from 0.0 to 1.0,
+     *          to an output from 0.0 to 1.0.
+     */
+    template <class Function>
+    void generate(Function f) {
+        for (uint16_t i = 0; i < NumPoints; ++i)
+            table[i] = sample(f, i);
+    }
+
+    /// Set the output value of point @f$ i @f$ of the table, at input
+    /// @f$ i \cdot 2^{\text{InBits} - \text{IndexBits}} @f$.
+    /// The value is in @f$ [0, 2^\text{OutBits}] @f$.
+    void setPoint(uint16_t i, entry_t value) { table[i] = value; }
+    /// Get the output value of point @f$ i @f$ of the table.
+    constexpr entry_t getPoint(uint16_t i) const { return table[i]; }
+
+    /**
+     * @brief   Evaluate the curve.
+     *
+     * @param   in
+     *          The input value, in @f$ [0, 2^\text{InBits} - 1] @f$.
+     * @return  The output value, in @f$ [0, 2^\text{OutBits} - 1] @f$.
+     */
+    constexpr uint16_t operator()(uint16_t in) const {
+        return clampOutput(interpolate(table[in >> FracBits],
+                                       table[(in >> FracBits) + (FracBits > 0)],
+                                       in & FracMask));
+    }
+
+    /// Evaluate a curve that is stored in flash memory (declared `PROGMEM`)
+    /// on AVR. On other platforms, this is the same as the call operator.
+    uint16_t evaluateProgmem(uint16_t in) const {
+#ifdef __AVR__
+        return clampOutput(
+            interpolate(readProgmem(table + (in >> FracBits)),
+                        readProgmem(table + (in >> FracBits) + (FracBits > 0)),
+                        in & FracMask));
+#else
+        return (*this)(in);
+#endif
+    }
+
+    /// @name   Built-in curves
+    /// @{
+
+    /// The output is equal to the input.
+    constexpr static CurveLUT linear() { return {}; }
+
+    /**
+     * @brief   Logarithmic curve,
+     *          @f$ y = \frac{\log(1 + (b - 1) x)}{\log(b)} @f$.
+     *
+     * Small inputs are expanded, large inputs are compressed. This is the
+     * inverse of @ref antiLogarithmic, it makes a logarithmic (audio) taper
+     * potentiometer behave like a linear one.
+     *
+     * @param   base
+     *          The ratio @f$ b > 1 @f$ between the slope at the start and the
+     *          slope at the end of the curve. The default of 100 corresponds
+     *          to a range of 40 dB.
+     *
+     * @note    The curve is steep near zero, so it needs more points than
+     *          the other curves to be accurate (e.g. `IndexBits = 8`).
+     */
+    constexpr static CurveLUT logarithmic(double base = 100) {
+        return fromFunction(Logarithmic{base});
+    }
+
+    /**
+     * @brief   Anti-logarithmic (exponential) curve,
+     *          @f$ y = \frac{b^x - 1}{b - 1} @f$.
+     *
+     * Small inputs are compressed, large inputs are expanded. It turns a
+     * linear potentiometer into an audio taper one, e.g. for volume controls.
+     *
+     * @param   base
+     *          The ratio @f$ b > 1 @f$ between the slope at the end and the
+     *          slope at the start of the curve.
+     */
+    constexpr static CurveLUT antiLogarithmic(double base = 100) {
+        return fromFunction(AntiLogarithmic{base});
+    }
+
+    /**
+     * @brief   S-shaped curve,
+     *          @f$ y = \frac{x^n}{x^n + (1 - x)^n} @f$.
+     *
+     * The response is less sensitive near both ends, and more sensitive in
+     * the middle.
+     *
+     * @param   steepness
+     *          The exponent @f$ n \ge 1 @f$, higher values result in a steeper
+     *          middle section. One gives a linear curve.
+     */
+    constexpr static CurveLUT sCurve(uint8_t steepness = 2) {
+        return fromFunction(SCurve{steepness});
+    }
+
+    /**
+     * @brief   Linear curve with dead zones at both ends: inputs below
+     *          `lower` map to zero, inputs above `upper` map to the maximum.
+     *
+     * Useful for potentiometers that don't reach the ends of the range, or
+     * that are noisy near the ends.
+     *
+     * @param   lower
+     *          The size of the dead zone at the start, as a fraction of the
+     *          input range.
+     * @param   upper
+     *          The size of the dead zone at the end, as a fraction of the
+     *          input range.
+     *
+     * @note    The edges of the dead zones are interpolated between the points
+     *          of the table, so they're only exact if they're at a point.
+     */
+    constexpr static CurveLUT deadZone(double lower = 0.02,
+                                       double upper = 0.02) {
+        return fromFunction(DeadZone{lower, 1 - upper});
+    }
+
+    /**
+     * @brief   Linear curve with a dead zone in the middle: inputs within
+     *          `width / 2` of the center map to the center, e.g. for
+     *          joysticks that don't return exactly to the center.
+     *
+     * @param   width
+     *          The size of the dead zone, as a fraction of the input range.
+     */
+    constexpr static CurveLUT centerDeadZone(double width = 0.05) {
+        return fromFunction(CenterDeadZone{width / 2});
+    }
+
+    /// @}
+
+  private:
+    struct Linear {
+        constexpr double operator()(double x) const { return x; }
+    };
+    struct Logarithmic {
+        double base;
+        constexpr double operator()(double x) const {
+            return detail::curveLog(1 + (base - 1) * x) /
+                   detail::curveLog(base);
+        }
+    };
+    struct AntiLogarithmic {
+        double base;
+        constexpr double operator()(double x) const {
+            return (detail::curveExp(x * detail::curveLog(base)) - 1) /
+                   (base - 1);
+        }
+    };
+    struct SCurve {
+        uint8_t n;
+        constexpr double operator()(double x) const {
+            return ratio(detail::curvePow(x, n), detail::curvePow(1 - x, n));
+        }
+        constexpr static double ratio(double a, double b) {
+            return a / (a + b);
+        }
+    };
+    struct DeadZone {
+        double lower, upper;
+        constexpr double operator()(double x) const {
+            return (x - lower) / (upper - lower);
+        }
+    };
+    struct CenterDeadZone {
+        double half;
+        constexpr double operator()(double x) const {
+            return x < 0.5 - half   ? x / (1 - 2 * half)
+                   : x > 0.5 + half ? (x - 2 * half) / (1 - 2 * half)
+                                    : 0.5;
+        }
+    };
+
+    using interp_t = typename std::conditional<
+        (OutBits + InBits - IndexBits < 31), int32_t, int64_t>::type;
+    constexpr static uint8_t FracBits = InBits - IndexBits;
+    constexpr static uint16_t FracMask = (1ul << FracBits) - 1;
+    constexpr static interp_t FracHalf = (interp_t(1) << FracBits) >> 1;
+
+    using Indices = typename detail::MakeCurveIndices<NumPoints>::type;
+
+    template <class Function, uint16_t... Is>
+    constexpr CurveLUT(Function f, detail::CurveIndices<Is...>)
+        : table{sample(f, Is)...} {}
+
+    /// Evaluate the function for point @f$ i @f$ of the table.
+    template <class Function>
+    constexpr static entry_t sample(Function f, uint16_t i) {
+        return toEntry(f(double(i) / (NumPoints - 1)));
+    }
+    /// Clamp to [0.0, 1.0], and scale to the output range.
+    constexpr static entry_t toEntry(double y) {
+        return y <= 0   ? entry_t(0)
+               : y >= 1 ? entry_t(1ul << OutBits)
+                        : entry_t(y * (1ul << OutBits) + 0.5);
+    }
+    constexpr static interp_t interpolate(interp_t y0, interp_t y1,
+                                          interp_t frac) {
+        // Arithmetic shift, the difference can be negative
+        return y0 + (((y1 - y0) * frac + FracHalf) >> FracBits);
+    }
+    constexpr static uint16_t clampOutput(interp_t y) {
+        return y > interp_t(MaxOut) ? MaxOut : uint16_t(y);
+    }
+#ifdef __AVR__
+    static uint16_t readProgmem(const uint16_t *p) { return pgm_read_word(p); }
+    static uint32_t readProgmem(const uint32_t *p) {
+        return pgm_read_dword(p);
+    }
+#endif
+
+    entry_t table[NumPoints];
+};
+
+/**
+ * @brief   Refers to a @ref CurveLUT that is stored elsewhere, so multiple
+ *          elements can share a single table.
+ *
+ * The curve has to outlive the reference, and on AVR, it has to be stored in
+ * flash memory:
+ *
+ * ```cpp
+ * constexpr CurveLUT<14> audioTaper PROGMEM = CurveLUT<14>::antiLogarithmic();
+ * CurveLUTRef<CurveLUT<14>> ref = audioTaper;
+ * ```
+ *
+ * A default-constructed reference doesn't refer to a curve, when used as the
+ * mapping function of a @ref GenericFilteredAnalog, the values are then passed
+ * through unchanged.
+ *
+ * @tparam  Curve
+ *          The type of the @ref CurveLUT.
+ */
+template <class Curve>
+class CurveLUTRef {
+  public:
+    /// Create a reference that doesn't refer to a curve.
+    constexpr CurveLUTRef() = default;
+    /// Refer to the given curve, which is stored in flash on AVR.
+    constexpr CurveLUTRef(const Curve &curve) : curve(&curve) {}
+    /// Don't refer to temporaries.
+    CurveLUTRef(const Curve &&) = delete;
+
+    /// Evaluate the curve.
+    uint16_t operator()(uint16_t in) const {
+        return curve->evaluateProgmem(in);
+    }
+    /// Check whether this refers to a curve.
+    explicit constexpr operator bool() const { return curve != nullptr; }
+
+  private:
+    const Curve *curve = nullptr;
+};
+
+/// @}
+
+END_AH_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
@@ -72,6 +72,17 @@ constexpr uint8_t ANALOG_FILTER_SHIFT_FACTOR = 2;
  */
 using ANALOG_FILTER_TYPE = uint16_t;
 
+/// The default parameters of the @ref OneEuroFilter, tuned for the values of
+/// @ref FilteredAnalog with the default settings (14 bits).
+/// @{
+/// Minimum cut-off frequency in Hz.
+constexpr float ONE_EURO_MIN_CUTOFF = 1.0f;
+/// Increase of the cut-off frequency in Hz per unit per second.
+constexpr float ONE_EURO_BETA = 0.002f;
+/// Cut-off frequency of the speed filter in Hz.
+constexpr float ONE_EURO_D_CUTOFF = 1.0f;
+/// @}
+
 /// The debounce time for momentary push buttons in milliseconds.
 constexpr unsigned long BUTTON_DEBOUNCE_TIME = 25; // milliseconds
 
@@ -86,9 +97,59 @@ constexpr unsigned long LONG_PRESS_DELAY = 450; // milliseconds
 /// The time between increments/decremnets during a long press.
 constexpr unsigned long LONG_PRESS_REPEAT_DELAY = 200; // milliseconds
 
+/// Allow @ref Updatable%s to be updated at their own rate instead of on every
+/// loop, and limit the time spent updating them per loop.
+/// Costs 8 bytes of RAM per Updatable. Disabled by default, because it changes
+/// the timing of the elements that have a default update rate (e.g. buttons).
+/// @see    Updatable::setUpdatePeriod
+#define UPDATABLE_SCHEDULING 0
+
+/// Measure how long every Updatable takes to update, and keep statistics and
+/// a histogram for each of them. Costs 48 bytes of RAM per Updatable.
+/// @see    UpdateProfile
+#define UPDATABLE_PROFILING 0
+
+/// The number of buckets of the @ref UpdateProfile histograms. Bucket
+/// @f$ i > 0 @f$ counts durations in @f$ [2^{i-1}, 2^i) @f$ µs, the last
+/// bucket counts all longer durations.
+constexpr uint8_t UPDATE_PROFILE_BUCKETS = 16;
+
+/// The update periods of the @ref UpdateRate classes, in microseconds.
+/// @{
+constexpr unsigned long UPDATE_PERIOD_FAST = 1000;       // 1 kHz, buttons
+constexpr unsigned long UPDATE_PERIOD_NORMAL = 2000;     // 500 Hz
+constexpr unsigned long UPDATE_PERIOD_SLOW = 10000;      // 100 Hz, touch
+constexpr unsigned long UPDATE_PERIOD_VERY_SLOW = 50000; // 20 Hz
+/// @}
+
 /// The interval between updating filtered analog inputs, in microseconds.
+/// Only used if @ref UPDATABLE_SCHEDULING is enabled.
 constexpr unsigned long FILTERED_INPUT_UPDATE_INTERVAL = 1000; // microseconds
 
+/// The default time between two samples of a @ref FilteredTouch sensor, in
+/// microseconds. Can be overridden by defining `TOUCH_UPDATE_INTERVAL` (in
+/// milliseconds) before including the library.
+constexpr unsigned long TOUCH_SAMPLE_PERIOD = 50000; // microseconds
+
+/// The default time between two triggers of an ultrasonic distance sensor, in
+/// microseconds. Should be long enough for the echoes of the previous
+/// measurement to die out.
+constexpr unsigned long ULTRASONIC_TRIGGER_INTERVAL = 50000; // microseconds
+
+/// The time in microseconds to wait for the echo of an ultrasonic distance
+/// sensor before giving up on a measurement.
+constexpr unsigned long ULTRASONIC_ECHO_TIMEOUT = 30000; // microseconds
+
+/// The default time between the end of one measurement and the start of the
+/// next in an ultrasonic sensor group, in microseconds, to keep late echoes
+/// from being picked up by the next sensor.
+constexpr unsigned long ULTRASONIC_GUARD_INTERVAL = 10000; // microseconds
+
+/// The maximum number of ultrasonic distance sensors that can use pin change
+/// interrupts at the same time. Other sensors fall back to polling their echo
+/// pin in `update()`. At most 8.
+constexpr uint8_t ULTRASONIC_MAX_INTERRUPTS = 8;
+
 constexpr static Frequency SPI_MAX_SPEED = 8_MHz;
 
 // ========================================================================== //
@@ -0,0 +1,49 @@
+#include "UpdateProfile.hpp"
+
+BEGIN_AH_NAMESPACE
+
+uint8_t UpdateProfile::getBucket(uint32_t duration) {
+    uint8_t bucket = 0;
+    while (duration != 0 && bucket < UPDATE_PROFILE_BUCKETS - 1) {
+        duration >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+void UpdateProfile::record(uint32_t duration) {
+    // Halve the sums before they overflow, this keeps the mean intact
+    if (total + duration < total || count == UINT32_MAX) {
+        total /= 2;
+        count /= 2;
+    }
+    ++count;
+    last = duration;
+    total += duration;
+    if (duration > max)
+        max = duration;
+    uint16_t &bucket = histogram[getBucket(duration)];
+    if (bucket != UINT16_MAX)
+        ++bucket;
+}
+
+void UpdateProfile::print(Print &os, const char *name, uint8_t index) const {
+    os.print(name);
+    os.print('[');
+    os.print(index);
+    os.print(F("] n="));
+    os.print(count);
+    os.print(F(" last="));
+    os.print(last);
+    os.print(F(" max="));
+    os.print(max);
+    os.print(F(" mean="));
+    os.print(getMean());
+    os.print(F(" hist="));
+    for (uint8_t i = 0; i < UPDATE_PROFILE_BUCKETS; ++i) {
+        os.print(histogram[i]);
+        os.print(i + 1 < UPDATE_PROFILE_BUCKETS ? ',' : '\n');
+    }
+}
+
+END_AH_NAMESPACE
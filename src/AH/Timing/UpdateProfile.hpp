@@ -0,0 +1,64 @@
+#pragma once
+
+#include <AH/Settings/Warnings.hpp>
+AH_DIAGNOSTIC_WERROR() // Enable errors on warnings
+
+AH_DIAGNOSTIC_EXTERNAL_HEADER()
+#include <AH/Arduino-Wrapper.h> // micros, Print
+AH_DIAGNOSTIC_POP()
+
+#include <AH/Settings/SettingsWrapper.hpp>
+#include <stdint.h>
+
+BEGIN_AH_NAMESPACE
+
+/// @addtogroup    AH_Timing
+/// @{
+
+/**
+ * @brief   Timing statistics of a single element: number of calls, the last,
+ *          maximum and mean duration, and a histogram with logarithmic 
+ *          buckets.
+ * 
+ * Updatables keep one of these when @ref UPDATABLE_PROFILING is enabled.
+ */
+struct UpdateProfile {
+    uint32_t count = 0; ///< Number of recorded calls.
+    uint32_t last = 0;  ///< Duration of the last call (µs).
+    uint32_t max = 0;   ///< Longest duration (µs).
+    uint32_t total = 0; ///< Sum of all durations (µs), for the mean.
+    /// Number of calls per duration bucket.
+    /// @see    UPDATE_PROFILE_BUCKETS
+    uint16_t histogram[UPDATE_PROFILE_BUCKETS] = {};
+
+    /// Add the duration of a call, in microseconds.
+    void record(uint32_t duration);
+    /// Get the mean duration, in microseconds.
+    uint32_t getMean() const { return count == 0 ? 0 : total / count; }
+    /// Clear all statistics.
+    void reset() { *this = {}; }
+    /// Print the statistics as a single line, prefixed by the given name and
+    /// index.
+    void print(Print &os, const char *name, uint8_t index) const;
+
+    /// Get the histogram bucket for the given duration.
+    static uint8_t getBucket(uint32_t duration);
+};
+
+/// Measures the duration of its scope, and records it in a profile.
+class UpdateProfileScope {
+  public:
+    UpdateProfileScope(UpdateProfile &profile)
+        : profile(profile), start(micros()) {}
+    ~UpdateProfileScope() { profile.record(micros() - start); }
+
+  private:
+    UpdateProfile &profile;
+    unsigned long start;
+};
+
+/// @}
+
+END_AH_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
@@ -2,10 +2,13 @@
 
 #include <Def/MIDIAddress.hpp>
 #include <MIDI_Parsers/MIDI_MessageTypes.hpp>
+#include <MIDI_Parsers/ControlChange14Assembler.hpp>
+#include <MIDI_Parsers/ParameterNumberAssembler.hpp>
 
 #include <Banks/Bank.hpp> // Bank<N>, BankSettingChangeCallback
 
 #include <AH/Containers/Updatable.hpp>
+#include <Settings/SettingsWrapper.hpp>
 #ifdef __AVR__
 #include <AH/STL/type_traits>
 #else
@@ -28,7 +31,11 @@ class MIDIInputElement : public AH::UpdatableCRTP<MIDIInputElement<Type>> {
     MIDIInputElement() = default;
 
   public:
+#if MIDI_INPUT_DISPATCH_INDEX
+    virtual ~MIDIInputElement() { indexRemove(this); }
+#else
     virtual ~MIDIInputElement() = default;
+#endif
 
   public:
     using MessageType =
@@ -49,13 +56,22 @@ class MIDIInputElement : public AH::UpdatableCRTP<MIDIInputElement<Type>> {
 
     /// Update all
     static bool updateAllWith(MessageType midimsg) {
+#if MIDI_INPUT_DISPATCH_INDEX
+        if (indexBuilt)
+            return updateIndexedWith(midimsg);
+#endif
+        bool found = false;
         for (auto &el : MIDIInputElement::updatables) {
             if (el.updateWith(midimsg)) {
+                if (deliverToAll) {
+                    found = true;
+                    continue;
+                }
                 el.moveDown();
                 return true;
             }
         }
-        return false;
+        return found;
     }
 
     /// Update all
@@ -66,16 +82,247 @@ class MIDIInputElement : public AH::UpdatableCRTP<MIDIInputElement<Type>> {
     /// Begin all
     static void beginAll() {
         MIDIInputElement::applyToAll(&MIDIInputElement::begin);
+#if MIDI_INPUT_DISPATCH_INDEX
+        rebuildDispatchIndex();
+#endif
     }
 
     /// Reset all
     static void resetAll() {
         MIDIInputElement::applyToAll(&MIDIInputElement::reset);
     }
+
+    /// Offer every incoming message to all elements that match it, instead of
+    /// stopping at the first element that accepts it.
+    static void setDeliverToAllMatches(bool all) { deliverToAll = all; }
+    /// @see    setDeliverToAllMatches
+    static bool getDeliverToAllMatches() { return deliverToAll; }
+
+  private:
+    static bool deliverToAll;
+
+#if MIDI_INPUT_DISPATCH_INDEX
+  public:
+    /// @name Dispatch index
+    /// @{
+
+    /**
+     * @brief   Get the MIDI address this element listens to, so it can be
+     *          filed in the dispatch index.
+     * 
+     * Only the channel and cable are used for Program Change, Channel Pressure
+     * and Pitch Bend elements. Elements that return an invalid address (the
+     * default) are offered every incoming message of their type, e.g. because
+     * they listen to multiple addresses. Elements that do return a valid 
+     * address are only offered messages with that address.
+     */
+    virtual MIDIAddress getDispatchAddress() const {
+        return MIDIAddress::invalid();
+    }
+
+    /// (Re)build the dispatch index from all enabled elements. Called by
+    /// @ref beginAll(). Call it again after changing the address of an element
+    /// that was already filed in the index.
+    static void rebuildDispatchIndex() {
+        for (auto &bucket : dispatchBuckets)
+            bucket = nullptr;
+        dispatchWildcards = nullptr;
+        for (auto &el : MIDIInputElement::updatables)
+            el.dispatchChain = nullptr;
+        for (auto &el : MIDIInputElement::updatables)
+            indexInsert(&el);
+        indexBuilt = true;
+    }
+
+    using MIDIInputElement::UpdatableCRTP::enable;
+    using MIDIInputElement::UpdatableCRTP::disable;
+
+    /// Enable this element, and add it to the dispatch index.
+    void enable() {
+        if (this->isEnabled()) {
+            ERROR(F("Error: This element is already enabled."), 0x1212);
+            return; // LCOV_EXCL_LINE
+        }
+        MIDIInputElement::UpdatableCRTP::enable();
+        if (indexBuilt)
+            indexInsert(this);
+    }
+    /// Disable this element, and remove it from the dispatch index.
+    void disable() {
+        if (!this->isEnabled()) {
+            ERROR(F("Error: This element is already disabled."), 0x1213);
+            return; // LCOV_EXCL_LINE
+        }
+        MIDIInputElement::UpdatableCRTP::disable();
+        indexRemove(this);
+    }
+
+    /// @copydoc enable()
+    static void enable(MIDIInputElement *element) { element->enable(); }
+    /// @copydoc enable()
+    static void enable(MIDIInputElement &element) { element.enable(); }
+    /// @copydoc enable()
+    template <class U, size_t N>
+    static void enable(U (&array)[N]) {
+        for (U &el : array)
+            enable(el);
+    }
+
+    /// @copydoc disable()
+    static void disable(MIDIInputElement *element) { element->disable(); }
+    /// @copydoc disable()
+    static void disable(MIDIInputElement &element) { element.disable(); }
+    /// @copydoc disable()
+    template <class U, size_t N>
+    static void disable(U (&array)[N]) {
+        for (U &el : array)
+            disable(el);
+    }
+
+    /// @}
+
+  private:
+    /// Only Note, Key Pressure and Control Change messages use their first
+    /// data byte as an address.
+    constexpr static bool keyHasAddress =
+        Type == MIDIMessageType::NoteOn || Type == MIDIMessageType::NoteOff ||
+        Type == MIDIMessageType::KeyPressure ||
+        Type == MIDIMessageType::ControlChange;
+
+    static int16_t dispatchKey(MIDIAddress address) {
+        if (!address)
+            return -1;
+        uint16_t key = (address.getRawCableNumber() << 4) |
+                       (address.getRawChannel() << 0);
+        if (keyHasAddress)
+            key = (key << 7) | (address.getAddress() & 0x7F);
+        return key;
+    }
+    static int16_t dispatchKey(ChannelMessage msg) {
+        return dispatchKey(msg.getAddress());
+    }
+    static int16_t dispatchKey(const SysExMessage &) { return -1; }
+
+    static uint8_t bucketOf(uint16_t key) {
+        key ^= key >> 7;
+        key ^= key >> 4;
+        return key & (MIDI_INPUT_DISPATCH_BUCKETS - 1);
+    }
+    static MIDIInputElement *&chainOf(int16_t key) {
+        return key < 0 ? dispatchWildcards : dispatchBuckets[bucketOf(key)];
+    }
+
+    /// Append the element to the end of its chain, so elements with the same
+    /// address keep their relative order.
+    static void indexInsert(MIDIInputElement *el) {
+        if (el->dispatchChain != nullptr) // already filed in a chain
+            return;
+        el->dispatchChain = &chainOf(dispatchKey(el->getDispatchAddress()));
+        el->nextInChain = nullptr;
+        MIDIInputElement **it = el->dispatchChain;
+        while (*it != nullptr)
+            it = &(*it)->nextInChain;
+        *it = el;
+    }
+    static void indexRemove(MIDIInputElement *el) {
+        if (el->dispatchChain == nullptr)
+            return;
+        MIDIInputElement **it = el->dispatchChain;
+        while (*it != nullptr && *it != el)
+            it = &(*it)->nextInChain;
+        if (*it == el)
+            *it = el->nextInChain;
+        el->dispatchChain = nullptr;
+        el->nextInChain = nullptr;
+    }
+
+    static bool updateChainWith(MIDIInputElement *el, MessageType midimsg) {
+        bool found = false;
+        while (el != nullptr) {
+            MIDIInputElement *next = el->nextInChain;
+            if (el->updateWith(midimsg)) {
+                if (!deliverToAll)
+                    return true;
+                found = true;
+            }
+            el = next;
+        }
+        return found;
+    }
+    static bool updateIndexedWith(MessageType midimsg) {
+        int16_t key = dispatchKey(midimsg);
+        bool found = key >= 0 && updateChainWith(chainOf(key), midimsg);
+        if (found && !deliverToAll)
+            return true;
+        return updateChainWith(dispatchWildcards, midimsg) || found;
+    }
+
+    static_assert((MIDI_INPUT_DISPATCH_BUCKETS &
+                   (MIDI_INPUT_DISPATCH_BUCKETS - 1)) == 0,
+                  "MIDI_INPUT_DISPATCH_BUCKETS should be a power of two");
+
+    /// The chain (bucket or wildcards) this element is filed in.
+    MIDIInputElement **dispatchChain = nullptr;
+    /// Next element in the same chain.
+    MIDIInputElement *nextInChain = nullptr;
+
+    static MIDIInputElement *dispatchBuckets[MIDI_INPUT_DISPATCH_BUCKETS];
+    static MIDIInputElement *dispatchWildcards;
+    static bool indexBuilt;
+#endif
 };
 
+template <MIDIMessageType Type>
+bool MIDIInputElement<Type>::deliverToAll = false;
+
+#if MIDI_INPUT_DISPATCH_INDEX
+template <MIDIMessageType Type>
+MIDIInputElement<Type> *
+    MIDIInputElement<Type>::dispatchBuckets[MIDI_INPUT_DISPATCH_BUCKETS];
+template <MIDIMessageType Type>
+MIDIInputElement<Type> *MIDIInputElement<Type>::dispatchWildcards = nullptr;
+template <MIDIMessageType Type>
+bool MIDIInputElement<Type>::indexBuilt = false;
+#endif
+
 // -------------------------------------------------------------------------- //
 
+#if MIDI_INPUT_DISPATCH_INDEX
+namespace detail {
+
+template <uint8_t N>
+struct MatcherRank : MatcherRank<N - 1> {};
+template <>
+struct MatcherRank<0> {};
+
+/// Matchers can provide their own dispatch address.
+template <class Matcher>
+auto matcherDispatchAddress(const Matcher &matcher, MatcherRank<3>)
+    -> decltype(MIDIAddress(matcher.getDispatchAddress())) {
+    return matcher.getDispatchAddress();
+}
+/// Range matchers (with an `address` and a `length`) match multiple
+/// addresses, so they have to be offered every message.
+template <class Matcher>
+auto matcherDispatchAddress(const Matcher &, MatcherRank<2>)
+    -> decltype((void)Matcher::length, MIDIAddress()) {
+    return MIDIAddress::invalid();
+}
+/// Matchers for a single address (or channel and cable).
+template <class Matcher>
+auto matcherDispatchAddress(const Matcher &matcher, MatcherRank<1>)
+    -> decltype(MIDIAddress(matcher.address)) {
+    return MIDIAddress(matcher.address);
+}
+/// Other matchers are offered every message.
+template <class Matcher>
+MIDIAddress matcherDispatchAddress(const Matcher &, MatcherRank<0>) {
+    return MIDIAddress::invalid();
+}
+
+} // namespace detail
+#endif
+
 /// The @ref MIDIInputElement base class is very general: you give it a MIDI
 /// message, and it calls the `updateWith()` method with that message. Each
 /// instance must then determine whether the message is meant for them or not.
@@ -106,6 +353,17 @@ class MatchingMIDIInputElement : public MIDIInputElement<Type> {
 
     virtual void handleUpdate(typename Matcher::Result match) = 0;
 
+#if MIDI_INPUT_DISPATCH_INDEX
+    /// The address of the matcher: its `getDispatchAddress()` if it has one,
+    /// otherwise its `address` member, unless it matches a range of
+    /// addresses (i.e. it has a `length` member). Matchers without an address
+    /// are offered every incoming message.
+    MIDIAddress getDispatchAddress() const override {
+        return detail::matcherDispatchAddress(matcher,
+                                              detail::MatcherRank<3>());
+    }
+#endif
+
   protected:
     Matcher matcher;
 };
@@ -135,6 +393,14 @@ class BankableMatchingMIDIInputElement
     virtual ~BankableMatchingMIDIInputElement() {
         this->matcher.getBank().remove(this);
     }
+
+#if MIDI_INPUT_DISPATCH_INDEX
+    /// The address depends on the active bank, so bankable elements are
+    /// offered every incoming message.
+    MIDIAddress getDispatchAddress() const override {
+        return MIDIAddress::invalid();
+    }
+#endif
 };
 
 // -------------------------------------------------------------------------- //
@@ -154,4 +420,77 @@ using MIDIInputElementPB = MIDIInputElement<MIDIMessageType::PITCH_BEND>;
 /// MIDI Input Element that listens for MIDI System Exclusive messages.
 using MIDIInputElementSysEx = MIDIInputElement<MIDIMessageType::SYSEX_START>;
 
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief   A class for objects that listen for values that are assembled from
+ *          multiple MIDI messages.
+ *
+ * @tparam  Message
+ *          The type of the assembled values: @ref ParameterNumberMessage for
+ *          RPN and NRPN values (see @ref ParameterNumberAssembler), or
+ *          @ref ControlChange14Message for the values of 14-bit controllers
+ *          (see @ref ControlChange14Assembler).
+ *
+ * Each change of a value is offered to the elements as a single message. The
+ * individual Control Change messages are still sent to the
+ * @ref MIDIInputElementCC elements as well.
+ */
+template <class Message>
+class AssembledMIDIInputElement
+    : public AH::UpdatableCRTP<AssembledMIDIInputElement<Message>> {
+  protected:
+    AssembledMIDIInputElement() = default;
+
+  public:
+    virtual ~AssembledMIDIInputElement() = default;
+
+    /// Initialize the input element.
+    virtual void begin() {} // LCOV_EXCL_LINE
+
+    /// Reset the input element to its initial state.
+    virtual void reset() {} // LCOV_EXCL_LINE
+
+    /// Update the value of the input element.
+    virtual void update() {} // LCOV_EXCL_LINE
+
+    /// Receive a new value and update the internal state.
+    virtual bool updateWith(Message msg) = 0;
+
+    /// Update all
+    static bool updateAllWith(Message msg) {
+        for (auto &el : AssembledMIDIInputElement::updatables) {
+            if (el.updateWith(msg)) {
+                el.moveDown();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Update all
+    static void updateAll() {
+        AssembledMIDIInputElement::applyToAll(
+            &AssembledMIDIInputElement::update);
+    }
+
+    /// Begin all
+    static void beginAll() {
+        AssembledMIDIInputElement::applyToAll(
+            &AssembledMIDIInputElement::begin);
+    }
+
+    /// Reset all
+    static void resetAll() {
+        AssembledMIDIInputElement::applyToAll(
+            &AssembledMIDIInputElement::reset);
+    }
+};
+
+/// MIDI Input Element that listens for RPN and NRPN values.
+using MIDIInputElementParameter =
+    AssembledMIDIInputElement<ParameterNumberMessage>;
+/// MIDI Input Element that listens for the values of 14-bit controllers.
+using MIDIInputElementCC14 = AssembledMIDIInputElement<ControlChange14Message>;
+
 END_CS_NAMESPACE
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include <Settings/SettingsWrapper.hpp>
+#if !DISABLE_PIPES
+
+#include "CoalescingMIDI_Pipe.hpp"
+#include <AH/Arduino-Wrapper.h> // micros
+#include <MIDI_Constants/Control_Change.hpp>
+
+BEGIN_CS_NAMESPACE
+
+bool CoalescingMIDI_Pipe::isCoalescable(ChannelMessage msg) {
+    switch (msg.getMessageType()) {
+        case MIDIMessageType::KeyPressure: // fallthrough
+        case MIDIMessageType::ChannelPressure: // fallthrough
+        case MIDIMessageType::PitchBend: return true;
+        case MIDIMessageType::ControlChange: {
+            uint8_t controller = msg.getData1();
+            // (N)RPN parameter selection and data entry only make sense in
+            // the order they were sent
+            if (controller == MIDI_CC::Data_Entry_MSB ||
+                controller == MIDI_CC::Data_Entry_MSB_LSB ||
+                (controller >= MIDI_CC::Data_Increment &&
+                 controller <= MIDI_CC::RPN_MSB))
+                return false;
+            // Channel mode messages
+            return controller < MIDI_CC::All_Sound_Off;
+        }
+        default: return false;
+    }
+}
+
+bool CoalescingMIDI_Pipe::sameSlot(const Slot &slot, ChannelMessage msg) {
+    if (slot.header != msg.header || slot.cable != msg.cable.getRaw())
+        return false;
+    // Channel Pressure and Pitch Bend have a single slot per channel
+    auto type = msg.getMessageType();
+    return type == MIDIMessageType::ChannelPressure ||
+           type == MIDIMessageType::PitchBend || slot.data1 == msg.data1;
+}
+
+void CoalescingMIDI_Pipe::forward(uint8_t index) {
+    ChannelMessage msg = pending[index].getMessage();
+    --numPending;
+    for (uint8_t i = index; i < numPending; ++i)
+        pending[i] = pending[i + 1];
+    sourceMIDItoSink(msg);
+}
+
+void CoalescingMIDI_Pipe::flush() {
+    for (uint8_t i = 0; i < numPending; ++i)
+        sourceMIDItoSink(pending[i].getMessage());
+    numPending = 0;
+    lastFlush = micros();
+}
+
+void CoalescingMIDI_Pipe::flushChannel(ChannelMessage msg) {
+    uint8_t i = 0;
+    while (i < numPending) {
+        const Slot &slot = pending[i];
+        if ((slot.header & 0x0F) == (msg.header & 0x0F) &&
+            slot.cable == msg.cable.getRaw())
+            forward(i);
+        else
+            ++i;
+    }
+}
+
+void CoalescingMIDI_Pipe::flushControllerPair(ChannelMessage msg) {
+    auto isLSB = [msg](const Slot &slot) {
+        return slot.header == msg.header && slot.cable == msg.cable.getRaw() &&
+               slot.data1 == msg.data1 + 0x20;
+    };
+    uint8_t i = 0;
+    while (i < numPending && !isLSB(pending[i]))
+        ++i;
+    if (i == numPending)
+        return;
+    // Forward the held MSB (which comes first) and LSB in their order
+    i = 0;
+    while (i < numPending) {
+        const Slot &slot = pending[i];
+        if (isLSB(slot) || sameSlot(slot, msg))
+            forward(i);
+        else
+            ++i;
+    }
+}
+
+void CoalescingMIDI_Pipe::setEnabled(bool enabled) {
+    if (!enabled)
+        flush();
+    this->enabled = enabled;
+}
+
+void CoalescingMIDI_Pipe::mapForwardMIDI(ChannelMessage msg) {
+    if (!enabled)
+        return sourceMIDItoSink(msg);
+    if (!isCoalescable(msg)) {
+        flushChannel(msg);
+        return sourceMIDItoSink(msg);
+    }
+    // Receivers reset the LSB of a 14-bit controller when they receive its
+    // MSB, so an LSB that is still held can't be sent after the new MSB
+    if (msg.getMessageType() == MIDIMessageType::ControlChange &&
+        msg.data1 < 0x20)
+        flushControllerPair(msg);
+    for (uint8_t i = 0; i < numPending; ++i) {
+        if (sameSlot(pending[i], msg)) {
+            pending[i].data1 = msg.data1;
+            pending[i].data2 = msg.data2;
+            ++numCoalesced;
+            return;
+        }
+    }
+    // If all slots are taken, make room by sending the oldest message
+    if (numPending == MIDI_COALESCING_SLOTS)
+        forward(0);
+    pending[numPending++] = {msg.header, msg.data1, msg.data2,
+                             msg.cable.getRaw()};
+}
+
+void CoalescingMIDI_Pipe::mapForwardMIDI(SysExMessage msg) {
+    flush();
+    sourceMIDItoSink(msg);
+}
+
+void CoalescingMIDI_Pipe::mapForwardMIDI(SysCommonMessage msg) {
+    flush();
+    sourceMIDItoSink(msg);
+}
+
+void CoalescingMIDI_Pipe::mapForwardMIDI(RealTimeMessage msg) {
+    sourceMIDItoSink(msg);
+}
+
+void CoalescingMIDI_Pipe::mapForwardMIDI(UMPMessage msg) {
+    flush();
+    sourceMIDItoSink(msg);
+}
+
+void CoalescingMIDI_Pipe::mapForwardNow() {
+    if (numPending > 0 && micros() - lastFlush >= interval)
+        flush();
+    sourceNowToSink();
+}
+
+END_CS_NAMESPACE
+
+#endif
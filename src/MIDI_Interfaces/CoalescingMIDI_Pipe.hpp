@@ -0,0 +1,115 @@
+#pragma once
+
+#include <Settings/SettingsWrapper.hpp>
+#if !DISABLE_PIPES
+
+#include "MIDI_Pipes.hpp"
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   A MIDI pipe that only forwards the latest value of continuous
+ *          controllers.
+ *
+ * Control Change, Pitch Bend, Channel Pressure and Key Pressure messages are
+ * held in a small table with one slot per cable, channel and controller (or
+ * note). A newer value overwrites the one that is waiting, and the held
+ * messages are forwarded when the source calls `sendNow()`, at most once per
+ * @ref setInterval "interval". When a fader moves faster than the MIDI link
+ * can carry its messages, the stale intermediate values are dropped instead
+ * of building a backlog, so the latency stays bounded.
+ *
+ * All other messages are forwarded immediately. To keep the order of
+ * messages within a channel intact (e.g. sustain pedal before Note Off),
+ * the values held for the same cable and channel are forwarded before a
+ * Note, Program Change or (N)RPN message. The same is done for all held
+ * values before System Exclusive, System Common and Universal MIDI Packets.
+ * Real-Time messages are never delayed.
+ *
+ * When a new MSB (controller 0-31) arrives while the LSB of the same
+ * 14-bit controller (controller + 32) is held, the held MSB and LSB are
+ * forwarded first, because receivers reset the LSB when they receive an MSB.
+ *
+ * The RPN/NRPN controllers (data entry, increment/decrement and parameter
+ * number selection) and the channel mode messages are never coalesced,
+ * since their meaning depends on the messages around them.
+ *
+ * @ref midimap_ uses a coalescing pipe for its output, see
+ * @ref midimap_::setCoalescing.
+ *
+ * @ingroup MIDI_Routing
+ */
+class CoalescingMIDI_Pipe : public MIDI_Pipe {
+  public:
+    /// Constructor.
+    CoalescingMIDI_Pipe(bool enabled = true) : enabled(enabled) {}
+
+    /// Enable or disable coalescing. When disabled, all messages are
+    /// forwarded immediately. Disabling forwards the held messages.
+    void setEnabled(bool enabled);
+    /// @see    setEnabled
+    bool isEnabled() const { return enabled; }
+
+    /// Set the minimum time between two flushes, in microseconds.
+    void setInterval(unsigned long interval) { this->interval = interval; }
+    /// @see    setInterval
+    unsigned long getInterval() const { return interval; }
+
+    /// Forward all held messages now, regardless of the interval.
+    void flush();
+
+    /// Get the number of messages that are currently held.
+    uint8_t getNumberOfPendingMessages() const { return numPending; }
+    /// Get the number of messages that were dropped because they were
+    /// overwritten by a newer value.
+    uint32_t getNumberOfCoalescedMessages() const { return numCoalesced; }
+
+    /// Check whether the given message can be coalesced, i.e. whether only
+    /// its latest value matters.
+    static bool isCoalescable(ChannelMessage msg);
+
+  private:
+    /// A held Channel Voice message.
+    struct Slot {
+        uint8_t header;
+        uint8_t data1;
+        uint8_t data2;
+        uint8_t cable;
+        ChannelMessage getMessage() const {
+            return ChannelMessage(
+                MIDIMessage(header, data1, data2, Cable(cable)));
+        }
+    };
+
+    void mapForwardMIDI(ChannelMessage msg) override;
+    void mapForwardMIDI(SysExMessage msg) override;
+    void mapForwardMIDI(SysCommonMessage msg) override;
+    void mapForwardMIDI(RealTimeMessage msg) override;
+    void mapForwardMIDI(UMPMessage msg) override;
+    void mapForwardNow() override;
+
+    /// Check whether the given message replaces the held one.
+    static bool sameSlot(const Slot &slot, ChannelMessage msg);
+    /// Forward the held messages for the cable and channel of the given
+    /// message.
+    void flushChannel(ChannelMessage msg);
+    /// Forward the held LSB (controller + 0x20) of the 14-bit controller
+    /// whose MSB is the given message, if there is one, together with the
+    /// held MSB.
+    void flushControllerPair(ChannelMessage msg);
+    /// Forward and remove the held message with the given index.
+    void forward(uint8_t index);
+
+  private:
+    /// The held messages, oldest first.
+    Slot pending[MIDI_COALESCING_SLOTS];
+    uint8_t numPending = 0;
+    bool enabled;
+    unsigned long interval = MIDI_COALESCING_INTERVAL;
+    unsigned long lastFlush = 0;
+    uint32_t numCoalesced = 0;
+};
+
+END_CS_NAMESPACE
+
+#endif
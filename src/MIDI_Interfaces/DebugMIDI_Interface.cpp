@@ -122,6 +122,20 @@ void PrintDebugMIDI_Base::sendRealTimeImpl(Print &stream, RealTimeMessage msg) {
     stream << "\r\n";
 }
 
+void PrintDebugMIDI_Base::sendUMPImpl(Print &stream, UMPMessage msg) {
+    if (!ensure_usb_init(stream))
+        return;
+    DEBUG_LOCK_MUTEX
+    if (prefix != nullptr)
+        stream << prefix << ' ';
+    uint8_t data[8];
+    uint8_t length = msg.toBytes(data);
+    stream << F("Universal Packet ") << AH::HexDump(data, length);
+    if (msg.getCable() != Cable_1)
+        stream << F("\tGroup: ") << msg.getCable().getOneBased();
+    stream << "\r\n";
+}
+
 void StreamDebugMIDI_Output::sendChannelMessageImpl(ChannelMessage m) {
     PrintDebugMIDI_Base::sendChannelMessageImpl(getStream(), m);
 }
@@ -134,6 +148,9 @@ void StreamDebugMIDI_Output::sendSysExImpl(SysExMessage m) {
 void StreamDebugMIDI_Output::sendRealTimeImpl(RealTimeMessage m) {
     PrintDebugMIDI_Base::sendRealTimeImpl(getStream(), m);
 }
+void StreamDebugMIDI_Output::sendUMPImpl(UMPMessage m) {
+    PrintDebugMIDI_Base::sendUMPImpl(getStream(), m);
+}
 void StreamDebugMIDI_Output::sendNowImpl() {
     PrintDebugMIDI_Base::sendNowImpl(getStream());
 }
@@ -150,6 +167,9 @@ void StreamDebugMIDI_Interface::sendSysExImpl(SysExMessage m) {
 void StreamDebugMIDI_Interface::sendRealTimeImpl(RealTimeMessage m) {
     PrintDebugMIDI_Base::sendRealTimeImpl(getStream(), m);
 }
+void StreamDebugMIDI_Interface::sendUMPImpl(UMPMessage m) {
+    PrintDebugMIDI_Base::sendUMPImpl(getStream(), m);
+}
 void StreamDebugMIDI_Interface::sendNowImpl() {
     PrintDebugMIDI_Base::sendNowImpl(getStream());
 }
@@ -18,6 +18,7 @@ class PrintDebugMIDI_Base {
     void sendSysCommonImpl(Print &, SysCommonMessage);
     void sendSysExImpl(Print &, SysExMessage);
     void sendRealTimeImpl(Print &, RealTimeMessage);
+    void sendUMPImpl(Print &, UMPMessage);
     void sendNowImpl(Print &) {}
 
   public:
@@ -51,6 +52,7 @@ class StreamDebugMIDI_Output : public PrintDebugMIDI_Base,
     void sendSysCommonImpl(SysCommonMessage);
     void sendSysExImpl(SysExMessage);
     void sendRealTimeImpl(RealTimeMessage);
+    void sendUMPImpl(UMPMessage);
     void sendNowImpl();
 
 #if !DISABLE_PIPES
@@ -58,6 +60,7 @@ class StreamDebugMIDI_Output : public PrintDebugMIDI_Base,
     void sinkMIDIfromPipe(SysExMessage m) override { send(m); }
     void sinkMIDIfromPipe(SysCommonMessage m) override { send(m); }
     void sinkMIDIfromPipe(RealTimeMessage m) override { send(m); }
+    void sinkMIDIfromPipe(UMPMessage m) override { send(m); }
 #endif
 
     Print &stream;
@@ -219,6 +222,7 @@ class StreamDebugMIDI_Interface : public PrintDebugMIDI_Base,
     void sendSysCommonImpl(SysCommonMessage) override;
     void sendSysExImpl(SysExMessage) override;
     void sendRealTimeImpl(RealTimeMessage) override;
+    void sendUMPImpl(UMPMessage) override;
     void sendNowImpl() override;
 
   private:
@@ -2,6 +2,7 @@
 
 #include <AH/Containers/CRTP.hpp>
 #include <MIDI_Parsers/MIDI_MessageTypes.hpp>
+#include <MIDI_Parsers/UMPMessage.hpp>
 
 BEGIN_CS_NAMESPACE
 
@@ -23,6 +24,8 @@ class MIDI_Callbacks {
     virtual void onSysCommonMessage(MIDI_Interface &, SysCommonMessage) {}
     /// Callback for incoming MIDI Real-Time Messages.
     virtual void onRealTimeMessage(MIDI_Interface &, RealTimeMessage) {}
+    /// Callback for incoming Universal MIDI Packets (MIDI 2.0 interfaces).
+    virtual void onUMPMessage(MIDI_Interface &, UMPMessage) {}
 
     /// Destructor.
     virtual ~MIDI_Callbacks() = default;
@@ -1,5 +1,6 @@
 #include "MIDI_Interface.hpp"
 #include "MIDI_Callbacks.hpp"
+#include <MIDI_Parsers/UMPTranslator.hpp>
 
 BEGIN_CS_NAMESPACE
 
@@ -10,6 +11,8 @@ BEGIN_CS_NAMESPACE
 MIDI_Interface::~MIDI_Interface() {
     if (getDefault() == this)
         DefaultMIDI_Interface = nullptr;
+    while (sysexConsumers.getFirst() != nullptr)
+        removeSysExConsumer(*sysexConsumers.getFirst());
 }
 
 void MIDI_Interface::setAsDefault() { DefaultMIDI_Interface = this; }
@@ -39,6 +42,9 @@ void MIDI_Interface::onChannelMessage(ChannelMessage message) {
 }
 
 void MIDI_Interface::onSysExMessage(SysExMessage message) {
+    sysexStreamed = streamSysEx(message);
+    if (sysexStreamed)
+        return;
     sourceMIDItoPipe(message);
     if (callbacks)
         callbacks->onSysExMessage(*this, message);
@@ -56,4 +62,85 @@ void MIDI_Interface::onRealTimeMessage(RealTimeMessage message) {
         callbacks->onRealTimeMessage(*this, message);
 }
 
+void MIDI_Interface::onUMPMessage(UMPMessage message) {
+    sourceMIDItoPipe(message);
+    if (callbacks)
+        callbacks->onUMPMessage(*this, message);
+}
+
+// -------------------------------------------------------------------------- //
+
+// Sending Universal MIDI Packets
+
+namespace {
+/// Sends translated messages using the given interface.
+struct SendTarget {
+    MIDI_Interface *iface;
+    template <class Message>
+    void operator()(Message msg) const {
+        iface->send(msg);
+    }
+};
+} // namespace
+
+void MIDI_Interface::sendUMPImpl(UMPMessage message) {
+    UMPToMIDI1Translator translator;
+    translator.translate(message);
+    translator.forEachMessage(SendTarget {this});
+}
+
+// -------------------------------------------------------------------------- //
+
+// Streaming System Exclusive input
+
+void MIDI_Interface::addSysExConsumer(SysExStreamConsumer &consumer) {
+    if (consumer.iface == this)
+        return;
+    if (consumer.iface != nullptr) {
+        ERROR(F("This consumer was already added to another interface"),
+              0x9148);
+        return;
+    }
+    sysexConsumers.append(consumer);
+    consumer.iface = this;
+}
+
+void MIDI_Interface::removeSysExConsumer(SysExStreamConsumer &consumer) {
+    if (consumer.iface != this)
+        return;
+    sysexConsumers.remove(consumer);
+    consumer.iface = nullptr;
+    consumer.activeCables = 0;
+}
+
+bool MIDI_Interface::streamSysEx(SysExMessage message) {
+    if (message.length == 0)
+        return false;
+    uint16_t cableBit = 1u << message.cable.getRaw();
+    bool start = message.data[0] == uint8_t(MIDIMessageType::SysExStart);
+    bool end =
+        message.data[message.length - 1] == uint8_t(MIDIMessageType::SysExEnd);
+    SysExStreamConsumer *streamConsumer = nullptr;
+    for (SysExStreamConsumer &consumer : sysexConsumers) {
+        // A new message on the same cable ends any unfinished ones
+        if (start)
+            consumer.activeCables &= ~cableBit;
+        if (streamConsumer != nullptr)
+            continue;
+        if (start ? consumer.matches(message)
+                  : consumer.isStreaming(message.cable))
+            streamConsumer = &consumer;
+    }
+    if (streamConsumer == nullptr)
+        return false;
+    if (end)
+        streamConsumer->activeCables &= ~cableBit;
+    else
+        streamConsumer->activeCables |= cableBit;
+    uint8_t flags = (start ? SysExStreamConsumer::Start : 0) |
+                    (end ? SysExStreamConsumer::End : 0);
+    streamConsumer->onSysExChunk(*this, message, flags);
+    return true;
+}
+
 END_CS_NAMESPACE
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "MIDI_Pipes.hpp"
 #include "MIDI_Sender.hpp"
 #include "MIDI_Staller.hpp"
+#include "SysExStreamConsumer.hpp"
 #include <AH/Containers/Updatable.hpp>
 #include <Def/Def.hpp>
 #include <Def/MIDIAddress.hpp>
@@ -63,6 +64,19 @@ class MIDI_Interface : public TrueMIDI_SinkSource,
 
     /// @}
 
+    /// @name   Streaming System Exclusive input
+    /// @{
+
+    /// Hand all incoming SysEx messages that start with the consumer's prefix
+    /// to the consumer, chunk by chunk, without stalling the MIDI pipes.
+    /// If the prefixes of multiple consumers match, the one that was added
+    /// first is used. A consumer can only be added to one interface.
+    void addSysExConsumer(SysExStreamConsumer &consumer);
+    /// Stop handing messages to the given consumer.
+    void removeSysExConsumer(SysExStreamConsumer &consumer);
+
+    /// @}
+
   protected:
     friend class MIDI_Sender<MIDI_Interface>;
     /// Low-level function for sending a MIDI channel voice message.
@@ -73,6 +87,10 @@ class MIDI_Interface : public TrueMIDI_SinkSource,
     virtual void sendSysExImpl(SysExMessage) = 0;
     /// Low-level function for sending a MIDI real-time message.
     virtual void sendRealTimeImpl(RealTimeMessage) = 0;
+    /// Low-level function for sending a Universal MIDI Packet. By default,
+    /// the packet is translated to MIDI 1.0 messages, interfaces that support
+    /// MIDI 2.0 can send it as is.
+    virtual void sendUMPImpl(UMPMessage);
     /// Low-level function for sending any buffered outgoing MIDI messages.
     virtual void sendNowImpl() = 0;
 
@@ -95,12 +113,30 @@ class MIDI_Interface : public TrueMIDI_SinkSource,
     void sinkMIDIfromPipe(SysCommonMessage msg) override { send(msg); }
     /// Accept an incoming MIDI Real-Time message from the source pipe.
     void sinkMIDIfromPipe(RealTimeMessage msg) override { send(msg); }
+    /// Accept an incoming Universal MIDI Packet from the source pipe.
+    void sinkMIDIfromPipe(UMPMessage msg) override { send(msg); }
+    /// Send any buffered outgoing messages, requested by the source pipe.
+    void sinkNowFromPipe() override { sendNow(); }
+    /// Start or end a transaction, requested by the source pipe.
+    void sinkTransactionFromPipe(bool active) override {
+        transactionActive = active;
+    }
 #endif
 
+  protected:
+    /// Check whether a transaction is active. Interfaces that normally send
+    /// every message immediately can hold on to them until @ref sendNow is
+    /// called while a transaction is active.
+    bool inTransaction() const { return transactionActive; }
+
+  private:
+    bool transactionActive = false;
+
   protected:
     /// Call the channel message callback and send the message to the sink pipe.
     void onChannelMessage(ChannelMessage message);
-    /// Call the SysEx message callback and send the message to the sink pipe.
+    /// Hand the SysEx message or chunk to a streaming consumer, or call the
+    /// SysEx message callback and send the message to the sink pipe.
     void onSysExMessage(SysExMessage message);
     /// Call the System Common message callback and send the message to the sink
     /// pipe.
@@ -108,6 +144,9 @@ class MIDI_Interface : public TrueMIDI_SinkSource,
     /// Call the real-time message callback and send the message to the sink
     /// pipe.
     void onRealTimeMessage(RealTimeMessage message);
+    /// Call the Universal MIDI Packet callback and send the packet to the
+    /// sink pipe.
+    void onUMPMessage(UMPMessage message);
 
   public:
     /// Read, parse and dispatch incoming MIDI messages on the given interface.
@@ -123,8 +162,30 @@ class MIDI_Interface : public TrueMIDI_SinkSource,
     static void handleStall(MIDIInterface_t *self);
     using MIDIStaller::handleStall;
 
+#if UPDATABLE_PROFILING
+  public:
+    /// Get the timing statistics of handling the incoming messages (calling
+    /// the callbacks and sending them down the pipes), per message.
+    const AH::UpdateProfile &getDispatchProfile() const {
+        return dispatchProfile;
+    }
+    /// Clear the statistics of @ref getDispatchProfile.
+    void resetDispatchProfile() { dispatchProfile.reset(); }
+
+  private:
+    AH::UpdateProfile dispatchProfile;
+#endif
+
+  private:
+    /// Offer a SysEx message or chunk to the streaming consumers.
+    /// @return True if a consumer accepted it.
+    bool streamSysEx(SysExMessage message);
+
   private:
     MIDI_Callbacks *callbacks = nullptr;
+    DoublyLinkedList<SysExStreamConsumer> sysexConsumers;
+    /// Whether the latest SysEx message or chunk went to a streaming consumer.
+    bool sysexStreamed = false;
 
   private:
     static MIDI_Interface *DefaultMIDI_Interface;
@@ -150,7 +211,9 @@ void MIDI_Interface::updateIncoming(MIDIInterface_t *self) {
         dispatchIncoming(self, event);
         if (event == MIDIReadEvent::SYSEX_CHUNK) {
             size_rem -= self->getSysExMessage().length;
-            chunked = true;
+            // Streamed messages don't need the pipes to wait for them
+            if (!self->sysexStreamed)
+                chunked = true;
         } else if (event == MIDIReadEvent::SYSEX_MESSAGE) {
             size_rem -= self->getSysExMessage().length;
             chunked = false;
@@ -164,14 +227,17 @@ void MIDI_Interface::updateIncoming(MIDIInterface_t *self) {
     if (chunked)
         self->stall(self);
 #endif
-    // TODO: add logic to detect MIDI messages such as (N)RPN that span over
-    // multiple channel voice messages and that shouldn't be interrupted.
-    // For short messages such as (N)RPN, I suggest waiting with a timeout.
+    // (N)RPN messages that span multiple channel messages don't have to be
+    // read in one go: midimap assembles them across calls, see
+    // ParameterNumberAssembler.
 }
 
 template <class MIDIInterface_t>
 void MIDI_Interface::dispatchIncoming(MIDIInterface_t *self,
                                       MIDIReadEvent event) {
+#if UPDATABLE_PROFILING
+    AH::UpdateProfileScope scope(self->dispatchProfile);
+#endif
     switch (event) {
         case MIDIReadEvent::CHANNEL_MESSAGE:
             self->onChannelMessage(self->getChannelMessage());
@@ -5,6 +5,7 @@
 #include "MIDI_Staller.hpp"
 #include <AH/Error/Error.hpp>
 #include <AH/STL/utility>
+#include <MIDI_Parsers/UMPTranslator.hpp>
 
 #if defined(ESP32) || !defined(ARDUINO)
 #include <mutex>
@@ -46,6 +47,23 @@ bool MIDI_Sink::disconnect(TrueMIDI_Source &source) {
 
 MIDI_Sink::~MIDI_Sink() { disconnectSourcePipes(); }
 
+namespace {
+/// Passes translated messages on to the sink they're meant for.
+struct SinkTarget {
+    MIDI_Sink *sink;
+    template <class Message>
+    void operator()(Message msg) const {
+        sink->sinkMIDIfromPipe(msg);
+    }
+};
+} // namespace
+
+void MIDI_Sink::sinkMIDIfromPipe(UMPMessage msg) {
+    UMPToMIDI1Translator translator;
+    translator.translate(msg);
+    translator.forEachMessage(SinkTarget {this});
+}
+
 MIDI_Sink::MIDI_Sink(MIDI_Sink &&other)
     : sourcePipe(std::exchange(other.sourcePipe, nullptr)) {
     if (this->hasSourcePipe()) {
@@ -154,6 +172,20 @@ void MIDI_Source::sourceMIDItoPipe(RealTimeMessage msg) {
         sinkPipe->acceptMIDIfromSource(msg);
     }
 }
+void MIDI_Source::sourceMIDItoPipe(UMPMessage msg) {
+    if (sinkPipe != nullptr) {
+        handleStallers();
+        sinkPipe->acceptMIDIfromSource(msg);
+    }
+}
+void MIDI_Source::sourceNowToPipe() {
+    if (sinkPipe != nullptr)
+        sinkPipe->acceptNowFromSource();
+}
+void MIDI_Source::sourceTransactionToPipe(bool active) {
+    if (sinkPipe != nullptr)
+        sinkPipe->acceptTransactionFromSource(active);
+}
 
 void MIDI_Source::stall(MIDIStaller *cause) {
     if (hasSinkPipe())
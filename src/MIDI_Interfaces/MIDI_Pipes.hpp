@@ -8,6 +8,7 @@
 #include <AH/STL/limits>
 #include <AH/STL/utility>
 #include <MIDI_Parsers/MIDI_MessageTypes.hpp>
+#include <MIDI_Parsers/UMPMessage.hpp>
 #include <Settings/NamespaceSettings.hpp>
 
 BEGIN_CS_NAMESPACE
@@ -101,6 +102,16 @@ class MIDI_Sink {
     virtual void sinkMIDIfromPipe(SysCommonMessage) = 0;
     /// Accept an incoming MIDI Real-Time message.
     virtual void sinkMIDIfromPipe(RealTimeMessage) = 0;
+    /// Accept an incoming Universal MIDI Packet. By default, the packet is
+    /// translated to MIDI 1.0 messages (see @ref UMPToMIDI1Translator),
+    /// which are passed to the other `sinkMIDIfromPipe` functions.
+    virtual void sinkMIDIfromPipe(UMPMessage);
+    /// Send any buffered outgoing MIDI messages. Does nothing by default.
+    virtual void sinkNowFromPipe() {}
+    /// Start or end a transaction: while a transaction is active, the sink
+    /// may hold on to the messages it receives until @ref sinkNowFromPipe is
+    /// called. Does nothing by default.
+    virtual void sinkTransactionFromPipe(bool active) { (void)active; }
 
     /// @}
 
@@ -186,6 +197,13 @@ class MIDI_Source {
     void sourceMIDItoPipe(SysCommonMessage);
     /// Send a MIDI Real-Time message down the pipe.
     void sourceMIDItoPipe(RealTimeMessage);
+    /// Send a Universal MIDI Packet down the pipe.
+    void sourceMIDItoPipe(UMPMessage);
+    /// Ask the sinks to send any buffered outgoing MIDI messages.
+    void sourceNowToPipe();
+    /// Start or end a transaction on the sinks.
+    /// @see    MIDI_Sink::sinkTransactionFromPipe
+    void sourceTransactionToPipe(bool active);
 
     /// @}
 
@@ -368,6 +386,17 @@ class MIDI_Pipe : private MIDI_Sink, private MIDI_Source {
     virtual void mapForwardMIDI(SysCommonMessage msg) { sourceMIDItoSink(msg); }
     /// @copydoc    mapForwardMIDI
     virtual void mapForwardMIDI(RealTimeMessage msg) { sourceMIDItoSink(msg); }
+    /// @copydoc    mapForwardMIDI
+    virtual void mapForwardMIDI(UMPMessage msg) { sourceMIDItoSink(msg); }
+    /// Called when the source asks to send any buffered messages. Pipes that
+    /// hold on to messages should forward them before calling
+    /// @ref sourceNowToSink.
+    virtual void mapForwardNow() { sourceNowToSink(); }
+    /// Called when the source starts or ends a transaction. Pipes that hold
+    /// on to messages should forward it after the messages before it.
+    virtual void mapForwardTransaction(bool active) {
+        sourceTransactionToSink(active);
+    }
 
     /// @}
 
@@ -522,6 +551,16 @@ class MIDI_Pipe : private MIDI_Sink, private MIDI_Source {
         if (hasSink())
             sink->sinkMIDIfromPipe(msg);
     }
+    /// Ask the sink of this pipe to send any buffered messages.
+    void sourceNowToSink() {
+        if (hasSink())
+            sink->sinkNowFromPipe();
+    }
+    /// Start or end a transaction on the sink of this pipe.
+    void sourceTransactionToSink(bool active) {
+        if (hasSink())
+            sink->sinkTransactionFromPipe(active);
+    }
 
   protected:
     /// Accept a MIDI message from the source, forward it to the “through”
@@ -534,6 +573,21 @@ class MIDI_Pipe : private MIDI_Sink, private MIDI_Source {
             getThroughOut()->acceptMIDIfromSource(msg);
         mapForwardMIDI(msg);
     }
+    /// Accept a request to send any buffered messages from the source, and
+    /// forward it to the “through” output and to the sink.
+    void acceptNowFromSource() {
+        if (hasThroughOut())
+            getThroughOut()->acceptNowFromSource();
+        mapForwardNow();
+    }
+    /// Accept the start or end of a transaction from the source, and forward
+    /// it to the “through” output and to the sink (using
+    /// @ref mapForwardTransaction).
+    void acceptTransactionFromSource(bool active) {
+        if (hasThroughOut())
+            getThroughOut()->acceptTransactionFromSource(active);
+        mapForwardTransaction(active);
+    }
 
   private:
     /// Called when data arrives from an upstream pipe connected to our
@@ -551,6 +605,14 @@ class MIDI_Pipe : private MIDI_Sink, private MIDI_Source {
     void sinkMIDIfromPipe(RealTimeMessage msg) override {
         sourceMIDItoSink(msg);
     }
+    /// @copydoc sinkMIDIfromPipe
+    void sinkMIDIfromPipe(UMPMessage msg) override { sourceMIDItoSink(msg); }
+    /// @copydoc sinkMIDIfromPipe
+    void sinkNowFromPipe() override { sourceNowToSink(); }
+    /// @copydoc sinkMIDIfromPipe
+    void sinkTransactionFromPipe(bool active) override {
+        sourceTransactionToSink(active);
+    }
 
   private:
     /// @name Private functions to stall and un-stall pipes
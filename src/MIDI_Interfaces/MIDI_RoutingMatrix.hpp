@@ -0,0 +1,401 @@
+#pragma once
+
+#include <Settings/SettingsWrapper.hpp>
+#if !DISABLE_PIPES
+
+#include "MIDI_Pipes.hpp"
+#include <AH/Error/Error.hpp>
+#include <AH/STL/type_traits>
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   Routes MIDI messages from a set of sources to a set of sinks using
+ *          a table of bit masks, instead of a chain of pipes.
+ *
+ * With regular @ref MIDI_Pipe "MIDI Pipes", every message from a source
+ * travels down the chain of “through” outputs of all pipes connected to that
+ * source. With many interfaces connected to each other, this chain gets long.
+ * The routing matrix has a single input pipe per source and a single output
+ * pipe per sink. For every source and @ref MessageClass "class of messages",
+ * a bit mask selects the sinks to send the messages to, so a message reaches
+ * all of its sinks in a single loop over the bits.
+ *
+ * The routes can be changed at any time using @ref route and @ref unroute,
+ * without allocating anything. A route can have a filter that changes or
+ * drops Channel Voice messages.
+ *
+ * The usual routing operators connect sources and sinks to the matrix, and
+ * route them to each other:
+ *
+ * ~~~cpp
+ * MIDI_RoutingMatrix<4, 4> matrix;
+ *
+ * midiA >> matrix >> midiB; // midiA to midiB
+ * midiA | matrix | midiC;   // midiA to and from midiC
+ * matrix.routeAll();        // every interface to every other interface
+ * ~~~
+ *
+ * @note    Stalling (exclusive access for chunked SysEx) does not propagate
+ *          through the matrix. Use regular pipes for sources that stall.
+ *
+ * @tparam  NumSources
+ *          The maximum number of sources.
+ * @tparam  NumSinks
+ *          The maximum number of sinks, at most 32.
+ *
+ * @ingroup MIDI_Routing
+ */
+template <uint8_t NumSources, uint8_t NumSinks = NumSources>
+class MIDI_RoutingMatrix {
+    static_assert(NumSinks <= 32, "At most 32 sinks are supported");
+
+  public:
+    /// A bit mask with one bit per sink.
+    using Mask = typename std::conditional<
+        (NumSinks <= 8), uint8_t,
+        typename std::conditional<(NumSinks <= 16), uint16_t,
+                                  uint32_t>::type>::type;
+
+    /// The classes of messages that can be routed separately. Can be
+    /// combined using the `|` operator.
+    enum MessageClass : uint8_t {
+        ChannelMessages = 1 << 0,   ///< Channel Voice and Mode messages.
+        SysExMessages = 1 << 1,     ///< System Exclusive messages.
+        SysCommonMessages = 1 << 2, ///< System Common messages.
+        RealTimeMessages = 1 << 3,  ///< System Real-Time messages.
+        AllMessages = 0x0F,         ///< All of the above.
+    };
+
+    /// A function that can change a Channel Voice message before it is sent
+    /// along a route. Returns false to drop the message.
+    using ChannelMessageFilter = bool (*)(ChannelMessage &);
+
+    /// An index that doesn't refer to any source or sink.
+    constexpr static uint8_t NotFound = 0xFF;
+
+    MIDI_RoutingMatrix() {
+        for (uint8_t i = 0; i < NumSources; ++i)
+            inputs[i].setMatrix(this, i);
+    }
+
+    /// Copying is not allowed.
+    MIDI_RoutingMatrix(const MIDI_RoutingMatrix &) = delete;
+    /// Copying is not allowed.
+    MIDI_RoutingMatrix &operator=(const MIDI_RoutingMatrix &) = delete;
+
+    /// @name Connecting sources and sinks
+    /// @{
+
+    /// Connect a source to the matrix (if it isn't already), and return its
+    /// index. No messages are routed until @ref route is called.
+    uint8_t addSource(TrueMIDI_Source &source) {
+        uint8_t index = findSource(source);
+        if (index != NotFound)
+            return lastSource = index;
+        if (numSources >= NumSources)
+            FATAL_ERROR(F("Not enough routing matrix sources available"),
+                        0x2460);
+        source.connectSinkPipe(&inputs[numSources]);
+        sources[numSources] = &source;
+        return lastSource = numSources++;
+    }
+    /// Connect a sink to the matrix (if it isn't already), and return its
+    /// index.
+    uint8_t addSink(TrueMIDI_Sink &sink) {
+        uint8_t index = findSink(sink);
+        if (index != NotFound)
+            return lastSink = index;
+        if (numSinks >= NumSinks)
+            FATAL_ERROR(F("Not enough routing matrix sinks available"),
+                        0x2461);
+        sink.connectSourcePipe(&outputs[numSinks]);
+        sinks[numSinks] = &sink;
+        return lastSink = numSinks++;
+    }
+    /// Connect an interface that is both a source and a sink. It won't be
+    /// routed to itself by @ref routeAll.
+    void addSinkSource(TrueMIDI_SinkSource &sinksource) {
+        uint8_t src = addSource(sinksource);
+        uint8_t snk = addSink(sinksource);
+        self[src] = bit(snk);
+    }
+
+    /// Get the index of the given source, or @ref NotFound.
+    uint8_t findSource(const TrueMIDI_Source &source) const {
+        for (uint8_t i = 0; i < numSources; ++i)
+            if (sources[i] == &source)
+                return i;
+        return NotFound;
+    }
+    /// Get the index of the given sink, or @ref NotFound.
+    uint8_t findSink(const TrueMIDI_Sink &sink) const {
+        for (uint8_t i = 0; i < numSinks; ++i)
+            if (sinks[i] == &sink)
+                return i;
+        return NotFound;
+    }
+
+    /// Get the index of the source that was added last.
+    uint8_t getLastSource() const { return lastSource; }
+    /// Get the index of the sink that was added last.
+    uint8_t getLastSink() const { return lastSink; }
+
+    /// @}
+
+    /// @name Routing
+    /// @{
+
+    /// Route the given classes of messages from a source to a sink.
+    void route(uint8_t source, uint8_t sink, uint8_t classes = AllMessages) {
+        for (uint8_t c = 0; c < NumClasses; ++c)
+            if (classes & (1 << c))
+                routes[source][c] |= bit(sink);
+    }
+    /// Stop routing the given classes of messages from a source to a sink.
+    void unroute(uint8_t source, uint8_t sink,
+                 uint8_t classes = AllMessages) {
+        for (uint8_t c = 0; c < NumClasses; ++c)
+            if (classes & (1 << c))
+                routes[source][c] &= ~bit(sink);
+    }
+    /// Route the given classes of messages from every source to every sink,
+    /// except from interfaces to themselves.
+    void routeAll(uint8_t classes = AllMessages) {
+        Mask all = numSinks == 32 ? Mask(~Mask(0)) : Mask(bit(numSinks) - 1);
+        for (uint8_t s = 0; s < numSources; ++s)
+            for (uint8_t c = 0; c < NumClasses; ++c)
+                if (classes & (1 << c))
+                    routes[s][c] = all & ~self[s];
+    }
+    /// Remove all routes and filters.
+    void clearRoutes() {
+        for (auto &source : routes)
+            for (auto &mask : source)
+                mask = 0;
+        for (auto &mask : filtered)
+            mask = 0;
+    }
+    /// Set the sinks that a source sends the given class of messages to.
+    void setRoutes(uint8_t source, MessageClass cls, Mask sinks) {
+        routes[source][classIndex(cls)] = sinks;
+    }
+    /// Get the sinks that a source sends the given class of messages to.
+    Mask getRoutes(uint8_t source, MessageClass cls) const {
+        return routes[source][classIndex(cls)];
+    }
+
+    /// Set the filter for Channel Voice messages from a source to a sink, or
+    /// `nullptr` to send them unchanged.
+    void setFilter(uint8_t source, uint8_t sink, ChannelMessageFilter filter) {
+        filters[source][sink] = filter;
+        if (filter)
+            filtered[source] |= bit(sink);
+        else
+            filtered[source] &= ~bit(sink);
+    }
+
+    /// @}
+
+  private:
+    constexpr static uint8_t NumClasses = 4;
+
+    constexpr static Mask bit(uint8_t index) { return Mask(1) << index; }
+    constexpr static uint8_t classIndex(MessageClass cls) {
+        return cls == ChannelMessages     ? 0
+               : cls == SysExMessages     ? 1
+               : cls == SysCommonMessages ? 2
+                                          : 3;
+    }
+
+    /// Receives the messages of one source.
+    class InputPipe : public MIDI_Pipe {
+      public:
+        void setMatrix(MIDI_RoutingMatrix *matrix, uint8_t index) {
+            this->matrix = matrix;
+            this->index = index;
+        }
+
+      private:
+        void mapForwardMIDI(ChannelMessage msg) override {
+            matrix->forward(index, msg);
+        }
+        void mapForwardMIDI(SysExMessage msg) override {
+            matrix->forward(index, msg);
+        }
+        void mapForwardMIDI(SysCommonMessage msg) override {
+            matrix->forward(index, msg);
+        }
+        void mapForwardMIDI(RealTimeMessage msg) override {
+            matrix->forward(index, msg);
+        }
+        void mapForwardMIDI(UMPMessage msg) override {
+            matrix->forward(index, msg);
+        }
+        void mapForwardNow() override { matrix->forwardNow(index); }
+        void mapForwardTransaction(bool active) override {
+            matrix->forwardTransaction(index, active);
+        }
+
+        MIDI_RoutingMatrix *matrix = nullptr;
+        uint8_t index = 0;
+    };
+
+    /// Sends messages to one sink.
+    class OutputPipe : public MIDI_Pipe {
+      public:
+        template <class Message>
+        void send(Message msg) {
+            sourceMIDItoSink(msg);
+        }
+        void sendNow() { sourceNowToSink(); }
+        void sendTransaction(bool active) { sourceTransactionToSink(active); }
+    };
+
+    template <class Message>
+    void forward(uint8_t source, Message msg) {
+        Mask mask = routes[source][classIndex(classOf(msg))];
+        for (OutputPipe *out = outputs; mask; mask >>= 1, ++out)
+            if (mask & 1)
+                out->send(msg);
+    }
+    void forward(uint8_t source, ChannelMessage msg) {
+        Mask mask = routes[source][0];
+        Mask filter = filtered[source];
+        for (uint8_t i = 0; mask; mask >>= 1, filter >>= 1, ++i) {
+            if (!(mask & 1))
+                continue;
+            if (filter & 1) {
+                ChannelMessage mapped = msg;
+                if (filters[source][i](mapped))
+                    outputs[i].send(mapped);
+            } else {
+                outputs[i].send(msg);
+            }
+        }
+    }
+    /// The sinks that receive any messages from the given source.
+    Mask connectedSinks(uint8_t source) const {
+        Mask mask = 0;
+        for (auto classMask : routes[source])
+            mask |= classMask;
+        return mask;
+    }
+    void forwardNow(uint8_t source) {
+        Mask mask = connectedSinks(source);
+        for (OutputPipe *out = outputs; mask; mask >>= 1, ++out)
+            if (mask & 1)
+                out->sendNow();
+    }
+    void forwardTransaction(uint8_t source, bool active) {
+        Mask mask = connectedSinks(source);
+        for (OutputPipe *out = outputs; mask; mask >>= 1, ++out)
+            if (mask & 1)
+                out->sendTransaction(active);
+    }
+
+    constexpr static MessageClass classOf(SysExMessage) {
+        return SysExMessages;
+    }
+    constexpr static MessageClass classOf(SysCommonMessage) {
+        return SysCommonMessages;
+    }
+    constexpr static MessageClass classOf(RealTimeMessage) {
+        return RealTimeMessages;
+    }
+    /// Universal MIDI Packets are routed like the MIDI 1.0 messages they
+    /// correspond to. Route filters are not applied to them.
+    static MessageClass classOf(UMPMessage msg) {
+        switch (msg.getMessageType()) {
+            case UMPMessageType::MIDI1ChannelVoice: // fallthrough
+            case UMPMessageType::MIDI2ChannelVoice: return ChannelMessages;
+            case UMPMessageType::Data64: return SysExMessages;
+            case UMPMessageType::SystemRealTimeCommon:
+                return msg.getStatus() < uint8_t(MIDIMessageType::TimingClock)
+                           ? SysCommonMessages
+                           : RealTimeMessages;
+            default: return RealTimeMessages;
+        }
+    }
+
+  private:
+    InputPipe inputs[NumSources];
+    OutputPipe outputs[NumSinks];
+    TrueMIDI_Source *sources[NumSources] = {};
+    TrueMIDI_Sink *sinks[NumSinks] = {};
+    Mask routes[NumSources][NumClasses] = {};
+    /// The sinks of each source that have a filter.
+    Mask filtered[NumSources] = {};
+    /// The sink that is the same interface as each source.
+    Mask self[NumSources] = {};
+    ChannelMessageFilter filters[NumSources][NumSinks] = {};
+    uint8_t numSources = 0;
+    uint8_t numSinks = 0;
+    uint8_t lastSource = NotFound;
+    uint8_t lastSink = NotFound;
+};
+
+/// Connect a source to a routing matrix (`source >> matrix`).
+template <uint8_t M, uint8_t N>
+inline MIDI_RoutingMatrix<M, N> &operator>>(TrueMIDI_Source &source,
+                                            MIDI_RoutingMatrix<M, N> &matrix) {
+    matrix.addSource(source);
+    return matrix;
+}
+
+/// Connect a sink to a routing matrix, and route the source that was
+/// connected last to it (`source >> matrix >> sink`).
+template <uint8_t M, uint8_t N>
+inline TrueMIDI_Sink &operator>>(MIDI_RoutingMatrix<M, N> &matrix,
+                                 TrueMIDI_Sink &sink) {
+    uint8_t index = matrix.addSink(sink);
+    if (matrix.getLastSource() != matrix.NotFound)
+        matrix.route(matrix.getLastSource(), index);
+    return sink;
+}
+
+/// Connect a sink to a routing matrix (`sink << matrix`).
+template <uint8_t M, uint8_t N>
+inline MIDI_RoutingMatrix<M, N> &operator<<(TrueMIDI_Sink &sink,
+                                            MIDI_RoutingMatrix<M, N> &matrix) {
+    matrix.addSink(sink);
+    return matrix;
+}
+
+/// Connect a source to a routing matrix, and route it to the sink that was
+/// connected last (`sink << matrix << source`).
+template <uint8_t M, uint8_t N>
+inline TrueMIDI_Source &operator<<(MIDI_RoutingMatrix<M, N> &matrix,
+                                   TrueMIDI_Source &source) {
+    uint8_t index = matrix.addSource(source);
+    if (matrix.getLastSink() != matrix.NotFound)
+        matrix.route(index, matrix.getLastSink());
+    return source;
+}
+
+/// Connect a sink+source to a routing matrix (`source+sink | matrix`).
+template <uint8_t M, uint8_t N>
+inline MIDI_RoutingMatrix<M, N> &operator|(TrueMIDI_SinkSource &sinksource,
+                                           MIDI_RoutingMatrix<M, N> &matrix) {
+    matrix.addSinkSource(sinksource);
+    return matrix;
+}
+
+/// Connect a sink+source to a routing matrix, and route it to and from the
+/// interface that was connected last (`source+sink | matrix | source+sink`).
+template <uint8_t M, uint8_t N>
+inline TrueMIDI_SinkSource &operator|(MIDI_RoutingMatrix<M, N> &matrix,
+                                      TrueMIDI_SinkSource &sinksource) {
+    uint8_t lastSource = matrix.getLastSource();
+    uint8_t lastSink = matrix.getLastSink();
+    matrix.addSinkSource(sinksource);
+    if (lastSource != matrix.NotFound)
+        matrix.route(lastSource, matrix.findSink(sinksource));
+    if (lastSink != matrix.NotFound)
+        matrix.route(matrix.findSource(sinksource), lastSink);
+    return sinksource;
+}
+
+END_CS_NAMESPACE
+
+#endif
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "ParameterNumberEncoder.hpp"
 #include <MIDI_Parsers/MIDI_MessageTypes.hpp>
+#include <MIDI_Parsers/UMPMessage.hpp>
 
 BEGIN_CS_NAMESPACE
 
@@ -67,6 +69,35 @@ class MIDI_Sender {
 
     /// @}
 
+    /// @name Sending Registered and Non-Registered Parameter Numbers
+    /// @{
+
+    /**
+     * @brief   Send a 14-bit value for a Non-Registered Parameter Number.
+     *
+     * The parameter number is only sent if a different parameter was
+     * selected on the channel before, and changes of the value are sent
+     * using as few Control Change messages as possible (see
+     * @ref ParameterNumberEncoder). Nothing is sent if the value didn't
+     * change.
+     *
+     * @param   address
+     *          The MIDI channel and cable.
+     * @param   number
+     *          The 14-bit parameter number. [0, 16383]
+     * @param   value
+     *          The 14-bit value. [0, 16383]
+     */
+    void sendNRPN(MIDIChannelCable address, uint16_t number, uint16_t value);
+    /// Send a 14-bit value for a Registered Parameter Number.
+    /// @see    sendNRPN
+    void sendRPN(MIDIChannelCable address, uint16_t number, uint16_t value);
+    /// Forget the parameter numbers and values that were sent, so the next
+    /// updates are sent in full, e.g. after the receiver was reset.
+    void resetParameterNumbers() { parameterNumbers.reset(); }
+
+    /// @}
+
     /// @name Sending MIDI System Common messages
     /// @{
 
@@ -132,6 +163,18 @@ class MIDI_Sender {
 
     /// @}
 
+    /// @name Sending Universal MIDI Packets
+    /// @{
+
+    /// Send a Universal MIDI Packet, e.g. a MIDI 2.0 Channel Voice message.
+    /// Interfaces that only support MIDI 1.0 translate it to MIDI 1.0
+    /// messages.
+    void send(UMPMessage message);
+    /// Send a MIDI 2.0 Control Change message with a 32-bit value.
+    void sendControlChange32(MIDIAddress address, uint32_t value);
+
+    /// @}
+
     /// @name Flushing the MIDI send buffer
     /// @{
 
@@ -172,6 +215,15 @@ class MIDI_Sender {
     sendPB(MIDIChannelCable address, uint16_t value);
 
     /// @}
+
+  private:
+    void sendParameterNumber(MIDIChannelCable address, bool registered,
+                             uint16_t number, uint16_t value);
+    /// Forget the parameter state of a channel when a parameter number or
+    /// data entry controller is sent directly.
+    void checkParameterNumberController(ChannelMessage message);
+
+    ParameterNumberEncoder parameterNumbers;
 };
 
 END_CS_NAMESPACE
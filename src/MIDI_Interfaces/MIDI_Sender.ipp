@@ -1,5 +1,6 @@
 #include "MIDI_Sender.hpp"
 #include <AH/Containers/CRTP.hpp>
+#include <MIDI_Parsers/ParameterNumberAssembler.hpp>
 
 BEGIN_CS_NAMESPACE
 
@@ -53,14 +54,17 @@ void MIDI_Sender<Derived>::sendKeyPressure(MIDIAddress address,
 template <class Derived>
 void MIDI_Sender<Derived>::sendControlChange(MIDIAddress address,
                                              uint8_t value) {
-    if (address)
-        CRTP(Derived).sendChannelMessageImpl({
+    if (address) {
+        ChannelMessage message {
             MIDIMessageType::ControlChange,
             address.getChannel(),
             address.getAddress(),
             uint8_t(value & 0x7F),
             address.getCableNumber(),
-        });
+        };
+        checkParameterNumberController(message);
+        CRTP(Derived).sendChannelMessageImpl(message);
+    }
 }
 template <class Derived>
 void MIDI_Sender<Derived>::sendProgramChange(MIDIChannelCable address,
@@ -125,10 +129,47 @@ template <class Derived>
 void MIDI_Sender<Derived>::send(ChannelMessage message) {
     if (message.hasValidChannelMessageHeader()) {
         message.sanitize();
+        checkParameterNumberController(message);
         CRTP(Derived).sendChannelMessageImpl(message);
     }
 }
 
+template <class Derived>
+void MIDI_Sender<Derived>::sendNRPN(MIDIChannelCable address, uint16_t number,
+                                    uint16_t value) {
+    sendParameterNumber(address, false, number, value);
+}
+template <class Derived>
+void MIDI_Sender<Derived>::sendRPN(MIDIChannelCable address, uint16_t number,
+                                   uint16_t value) {
+    sendParameterNumber(address, true, number, value);
+}
+template <class Derived>
+void MIDI_Sender<Derived>::sendParameterNumber(MIDIChannelCable address,
+                                               bool registered,
+                                               uint16_t number,
+                                               uint16_t value) {
+    if (!address)
+        return;
+    auto ccs = parameterNumbers.encode(address, registered, number, value);
+    for (uint8_t i = 0; i < ccs.count; ++i)
+        CRTP(Derived).sendChannelMessageImpl({
+            MIDIMessageType::ControlChange,
+            address.getChannel(),
+            ccs.controllers[i],
+            ccs.values[i],
+            address.getCableNumber(),
+        });
+}
+template <class Derived>
+void MIDI_Sender<Derived>::checkParameterNumberController(
+    ChannelMessage message) {
+    if (message.getMessageType() == MIDIMessageType::ControlChange &&
+        ParameterNumberAssembler::isParameterNumberController(
+            message.getData1()))
+        parameterNumbers.invalidate({message.getChannel(), message.getCable()});
+}
+
 template <class Derived>
 void MIDI_Sender<Derived>::send(SysCommonMessage message) {
     if (message.hasValidSystemCommonHeader()) {
@@ -222,6 +263,18 @@ void MIDI_Sender<Derived>::sendSystemReset(Cable cable) {
     sendRealTime(MIDIMessageType::SystemReset, cable);
 }
 
+template <class Derived>
+void MIDI_Sender<Derived>::send(UMPMessage message) {
+    CRTP(Derived).sendUMPImpl(message);
+}
+
+template <class Derived>
+void MIDI_Sender<Derived>::sendControlChange32(MIDIAddress address,
+                                               uint32_t value) {
+    if (address)
+        send(UMPMessage::controlChange(address, value));
+}
+
 template <class Derived>
 void MIDI_Sender<Derived>::sendNow() {
     CRTP(Derived).sendNowImpl();
@@ -0,0 +1,70 @@
+#include "ParameterNumberEncoder.hpp"
+#include <MIDI_Constants/Control_Change.hpp>
+
+BEGIN_CS_NAMESPACE
+
+static uint8_t keyOf(MIDIChannelCable address) {
+    return (address.getRawCableNumber() << 4) | address.getRawChannel();
+}
+
+auto ParameterNumberEncoder::encode(MIDIChannelCable address, bool registered,
+                                    uint16_t number, uint16_t value)
+    -> Result {
+    Result result;
+    auto add = [&result](uint8_t controller, uint8_t value) {
+        result.controllers[result.count] = controller;
+        result.values[result.count] = value & 0x7F;
+        ++result.count;
+    };
+    number &= 0x3FFF;
+    value &= 0x3FFF;
+
+    // Find the slot of this channel, or take the least recently used one,
+    // and move it to the front
+    uint8_t key = keyOf(address);
+    uint8_t i = 0;
+    while (i < NRPN_OUTPUT_SLOTS - 1 &&
+           !((slots[i].flags & Used) && slots[i].key == key))
+        ++i;
+    Slot slot = slots[i];
+    if (!(slot.flags & Used) || slot.key != key)
+        slot = {key, 0, 0, 0};
+    for (; i > 0; --i)
+        slots[i] = slots[i - 1];
+
+    // Select the parameter number if it changed
+    uint8_t reg = registered ? Registered : 0;
+    if (!(slot.flags & Used) || (slot.flags & Registered) != reg ||
+        slot.number != number) {
+        add(registered ? MIDI_CC::RPN_MSB : MIDI_CC::NRPN_MSB, number >> 7);
+        add(registered ? MIDI_CC::RPN_LSB : MIDI_CC::NRPN_LSB, number);
+        slot.flags = Used | reg;
+        slot.number = number;
+    }
+
+    // Send the value, or just its LSB if the MSB didn't change
+    bool known = slot.flags & ValueKnown;
+    if (!known || value != slot.value) {
+        if (!known || (value >> 7) != (slot.value >> 7))
+            add(MIDI_CC::Data_Entry_MSB, value >> 7);
+        add(MIDI_CC::Data_Entry_MSB_LSB, value);
+    }
+    slot.flags |= ValueKnown;
+    slot.value = value;
+    slots[0] = slot;
+    return result;
+}
+
+void ParameterNumberEncoder::invalidate(MIDIChannelCable address) {
+    uint8_t key = keyOf(address);
+    for (auto &slot : slots)
+        if (slot.key == key)
+            slot.flags = 0;
+}
+
+void ParameterNumberEncoder::reset() {
+    for (auto &slot : slots)
+        slot.flags = 0;
+}
+
+END_CS_NAMESPACE
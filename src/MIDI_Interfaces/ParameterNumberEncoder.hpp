@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Def/MIDIAddress.hpp>
+#include <Settings/SettingsWrapper.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   Converts RPN and NRPN values to the shortest sequence of Control
+ *          Change messages, given the parameters and values that were sent
+ *          before.
+ *
+ * A full (N)RPN update consists of four Control Change messages: the MSB and
+ * LSB of the parameter number, and the MSB and LSB of the value (12 bytes).
+ * The encoder remembers the selected parameter number and the last value for
+ * the @ref NRPN_OUTPUT_SLOTS most recently used channels, so it can omit the
+ * parameter number if it hasn't changed, and send just the Data Entry LSB if
+ * the MSB of the value didn't change. Most consecutive updates of the same
+ * parameter then take a single message.
+ *
+ * Data Increment and Data Decrement are never sent: receivers don't agree on
+ * the step size (some step the LSB, others the MSB or a step size of their
+ * own), and the Data Entry LSB takes a single message as well.
+ *
+ * This only works if the encoder sees all parameter number messages that are
+ * sent on the channel, see @ref invalidate.
+ *
+ * @ingroup MIDIInterfaces
+ */
+class ParameterNumberEncoder {
+  public:
+    /// The Control Change messages to send.
+    struct Result {
+        uint8_t count = 0;
+        uint8_t controllers[4];
+        uint8_t values[4];
+    };
+
+    /**
+     * @brief   Get the Control Change messages to send for the given update.
+     *
+     * @param   address
+     *          The channel and cable to send the parameter on.
+     * @param   registered
+     *          True for an RPN, false for an NRPN.
+     * @param   number
+     *          The 14-bit parameter number.
+     * @param   value
+     *          The new 14-bit value.
+     * @return  The messages to send, none if the value didn't change.
+     */
+    Result encode(MIDIChannelCable address, bool registered, uint16_t number,
+                  uint16_t value);
+
+    /// Forget the state of the given channel, e.g. because a parameter number
+    /// or data entry controller was sent without using the encoder.
+    void invalidate(MIDIChannelCable address);
+    /// Forget the state of all channels, so the next update of every
+    /// parameter is sent in full.
+    void reset();
+
+  private:
+    enum Flags : uint8_t {
+        Used = 1 << 0,       ///< The slot is in use.
+        Registered = 1 << 1, ///< The selected parameter is an RPN.
+        ValueKnown = 1 << 2, ///< The receiver knows @ref Slot::value.
+    };
+    struct Slot {
+        uint8_t key;
+        uint8_t flags;
+        uint16_t number;
+        uint16_t value;
+    };
+
+    Slot slots[NRPN_OUTPUT_SLOTS] = {};
+};
+
+END_CS_NAMESPACE
@@ -0,0 +1,283 @@
+#pragma once
+
+#include <Settings/SettingsWrapper.hpp>
+#if !DISABLE_PIPES
+
+#include "MIDI_Pipes.hpp"
+#include <AH/Arduino-Wrapper.h> // yield
+#include <AH/Containers/Updatable.hpp>
+#include <AH/Error/Error.hpp>
+#include <AH/STL/cstdint>
+#include <string.h> // memcpy
+
+#ifdef __AVR__
+#include <util/atomic.h>
+#else
+#include <atomic>
+#endif
+
+BEGIN_CS_NAMESPACE
+
+#ifdef __AVR__
+/// Read and write index of a @ref QueuedMIDI_Pipe, for producers that run in
+/// an interrupt handler. Disables interrupts while accessing the index,
+/// because 16-bit accesses are not atomic on AVR.
+struct MIDIQueueIndex {
+    using type = uint16_t;
+    constexpr static size_t alignment = alignof(type);
+    volatile type value = 0;
+    type load_acquire() const {
+        type t;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { t = value; }
+        return t;
+    }
+    void store_release(type t) {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { value = t; }
+    }
+};
+#else
+/// Read and write index of a @ref QueuedMIDI_Pipe. Only loaded and stored,
+/// never modified atomically, so it is lock-free on all ARM cores.
+struct MIDIQueueIndex {
+    using type = uint32_t;
+    /// Alignment of the read and write index, to avoid false sharing.
+#if defined(ESP32)
+    constexpr static size_t alignment = 32; // default cache size
+#elif !defined(ARDUINO)
+    constexpr static size_t alignment = 64;
+#else
+    constexpr static size_t alignment = alignof(type);
+#endif
+    std::atomic<type> value {0};
+    type load_acquire() const { return value.load(std::memory_order_acquire); }
+    void store_release(type t) { value.store(t, std::memory_order_release); }
+};
+#endif
+
+/**
+ * @brief   A MIDI pipe that hands messages from one thread (or interrupt
+ *          handler) to another through a wait-free single-producer,
+ *          single-consumer queue.
+ *
+ * Normally, a message travels from the source to the sink on the stack of
+ * the code that sends it. With a queued pipe, the source only copies the
+ * message into a fixed-size ring buffer; the sink receives it later, when
+ * the consumer calls @ref update(), e.g. a sensor task on one core of an
+ * ESP32 sends, and `midimap.loop()` on the other core calls @ref update()
+ * to pass the messages on to the USB or BLE interface. Neither side ever
+ * waits for the other (unless the @ref OverflowPolicy::Block "Block"
+ * overflow policy is used).
+ *
+ * System Exclusive messages are copied into the queue as well, so the
+ * source's buffer can be reused as soon as sending returns. Requests to
+ * send buffered messages (`sendNow()`) and transactions are queued in order
+ * with the messages.
+ *
+ * Only a single thread may send to the pipe, and only a single thread may
+ * call @ref update(). Stalling is not supported across the queue.
+ *
+ * @tparam  Capacity
+ *          The size of the ring buffer in bytes, a power of two. Every
+ *          message takes up 4 bytes of header, plus its data rounded up to a
+ *          multiple of 4 bytes. SysEx messages larger than half the capacity
+ *          (minus the header) are dropped.
+ *
+ * @ingroup MIDI_Routing
+ */
+template <uint16_t Capacity = MIDI_QUEUE_CAPACITY>
+class QueuedMIDI_Pipe : public MIDI_Pipe, public AH::Updatable<> {
+    static_assert((Capacity & (Capacity - 1)) == 0 && Capacity >= 16,
+                  "Capacity should be a power of two");
+
+  public:
+    /// What to do with a message when the queue is full.
+    enum class OverflowPolicy : uint8_t {
+        DropNewest, ///< Discard the new message (and count it).
+        Block,      ///< Wait for the consumer to make room. Don't use this
+                    ///< if the producer could be the consumer, or an ISR.
+        Error,      ///< Raise a fatal error.
+    };
+
+    /// Constructor.
+    QueuedMIDI_Pipe(OverflowPolicy policy = OverflowPolicy::DropNewest)
+        : policy(policy) {}
+
+    /// @name Consumer side
+    /// @{
+
+    /// Does nothing.
+    void begin() override {}
+    /// Forward all queued messages to the sink.
+    void update() override {
+        while (forwardNext())
+            ;
+    }
+    /// Forward the oldest queued message to the sink.
+    /// @retval false   The queue is empty.
+    bool forwardNext();
+
+    /// @}
+
+    /// @name Overflow handling
+    /// @{
+
+    void setOverflowPolicy(OverflowPolicy policy) { this->policy = policy; }
+    OverflowPolicy getOverflowPolicy() const { return policy; }
+    /// Get the number of messages that were dropped because the queue was
+    /// full, or because they were too large.
+    uint32_t getNumberOfDroppedMessages() const { return dropped; }
+
+    /// @}
+
+    /// Get the number of bytes in use. May be out of date by the time it
+    /// returns.
+    uint16_t getUsedBytes() const {
+        return writeIndex.load_acquire() - readIndex.load_acquire();
+    }
+
+  private:
+    enum RecordType : uint8_t {
+        Wrap,          ///< The rest of the buffer is unused.
+        Channel,       ///< Channel Voice message.
+        SysEx,         ///< System Exclusive message, data inline.
+        SysCommon,     ///< System Common message.
+        RealTime,      ///< System Real-Time message.
+        Now,           ///< Request to send buffered messages.
+        BeginTransaction,
+        EndTransaction,
+        Universal,     ///< Universal MIDI Packet, both words.
+    };
+    struct Header {
+        uint8_t type;
+        uint8_t cable;
+        uint16_t length;
+    };
+    constexpr static uint16_t HeaderSize = sizeof(Header);
+    static_assert(HeaderSize == 4, "");
+    using index_t = typename MIDIQueueIndex::type;
+
+    constexpr static uint16_t align(uint16_t size) {
+        return (size + HeaderSize - 1) & ~(HeaderSize - 1);
+    }
+
+    void mapForwardMIDI(ChannelMessage msg) override {
+        uint8_t data[] {msg.header, msg.data1, msg.data2};
+        push(Channel, msg.cable, data, sizeof(data));
+    }
+    void mapForwardMIDI(SysExMessage msg) override {
+        push(SysEx, msg.cable, msg.data, msg.length);
+    }
+    void mapForwardMIDI(SysCommonMessage msg) override {
+        uint8_t data[] {msg.header, msg.data1, msg.data2};
+        push(SysCommon, msg.cable, data, sizeof(data));
+    }
+    void mapForwardMIDI(RealTimeMessage msg) override {
+        push(RealTime, msg.cable, &msg.message, 1);
+    }
+    void mapForwardMIDI(UMPMessage msg) override {
+        push(Universal, msg.getCable(),
+             reinterpret_cast<const uint8_t *>(msg.words), sizeof(msg.words));
+    }
+    void mapForwardNow() override { push(Now, Cable_1, nullptr, 0); }
+    void mapForwardTransaction(bool active) override {
+        push(active ? BeginTransaction : EndTransaction, Cable_1, nullptr, 0);
+    }
+
+    /// Copy a record into the queue (producer side).
+    void push(RecordType type, Cable cable, const uint8_t *data,
+              uint16_t length);
+
+  private:
+    uint8_t buffer[Capacity];
+    alignas(MIDIQueueIndex::alignment) MIDIQueueIndex writeIndex;
+    alignas(MIDIQueueIndex::alignment) MIDIQueueIndex readIndex;
+    OverflowPolicy policy;
+    volatile uint32_t dropped = 0;
+};
+
+template <uint16_t Capacity>
+void QueuedMIDI_Pipe<Capacity>::push(RecordType type, Cable cable,
+                                     const uint8_t *data, uint16_t length) {
+    uint16_t size = HeaderSize + align(length);
+    // Larger records might not fit even in an empty buffer, because of the
+    // padding at the end
+    if (size > Capacity / 2) {
+        dropped = dropped + 1;
+        return;
+    }
+    // Only this thread writes the write index
+    index_t write = writeIndex.load_acquire();
+    uint16_t pos = write % Capacity;
+    // Records are never split, skip the end of the buffer if it's too short
+    uint16_t padding = Capacity - pos < size ? Capacity - pos : 0;
+    while (index_t(write + padding + size - readIndex.load_acquire()) >
+           Capacity) {
+        if (policy == OverflowPolicy::DropNewest) {
+            dropped = dropped + 1;
+            return;
+        } else if (policy == OverflowPolicy::Error) {
+            FATAL_ERROR(F("MIDI queue full"), 0x2462);
+            return; // LCOV_EXCL_LINE
+        }
+        yield();
+    }
+    if (padding > 0) {
+        Header wrap {Wrap, 0, 0};
+        memcpy(buffer + pos, &wrap, HeaderSize);
+        write += padding;
+        pos = 0;
+    }
+    Header header {type, cable.getRaw(), length};
+    memcpy(buffer + pos, &header, HeaderSize);
+    if (length > 0)
+        memcpy(buffer + pos + HeaderSize, data, length);
+    writeIndex.store_release(write + size);
+}
+
+template <uint16_t Capacity>
+bool QueuedMIDI_Pipe<Capacity>::forwardNext() {
+    // Only this thread writes the read index
+    index_t read = readIndex.load_acquire();
+    if (read == writeIndex.load_acquire())
+        return false;
+    uint16_t pos = read % Capacity;
+    Header header;
+    memcpy(&header, buffer + pos, HeaderSize);
+    if (header.type == Wrap) {
+        // The producer always writes a record after the padding
+        read += Capacity - pos;
+        pos = 0;
+        memcpy(&header, buffer, HeaderSize);
+    }
+    const uint8_t *data = buffer + pos + HeaderSize;
+    Cable cable {header.cable};
+    switch (header.type) {
+        case Channel:
+            sourceMIDItoSink(
+                ChannelMessage(MIDIMessage(data[0], data[1], data[2], cable)));
+            break;
+        case SysEx: sourceMIDItoSink(SysExMessage(data, header.length, cable));
+            break;
+        case SysCommon:
+            sourceMIDItoSink(SysCommonMessage(
+                MIDIMessage(data[0], data[1], data[2], cable)));
+            break;
+        case RealTime: sourceMIDItoSink(RealTimeMessage(data[0], cable)); break;
+        case Universal: {
+            UMPMessage msg;
+            memcpy(msg.words, data, sizeof(msg.words));
+            sourceMIDItoSink(msg);
+        } break;
+        case Now: sourceNowToSink(); break;
+        case BeginTransaction: sourceTransactionToSink(true); break;
+        case EndTransaction: sourceTransactionToSink(false); break;
+        default: break;
+    }
+    // Release the space only after the sink is done with the SysEx data
+    readIndex.store_release(read + HeaderSize + align(header.length));
+    return true;
+}
+
+END_CS_NAMESPACE
+
+#endif
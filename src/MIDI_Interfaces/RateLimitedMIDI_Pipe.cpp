@@ -0,0 +1,170 @@
+#include <Settings/SettingsWrapper.hpp>
+#if !DISABLE_PIPES
+
+#include "CoalescingMIDI_Pipe.hpp"
+#include "RateLimitedMIDI_Pipe.hpp"
+#include <AH/Arduino-Wrapper.h> // micros
+#include <MIDI_Parsers/UMPTranslator.hpp>
+
+BEGIN_CS_NAMESPACE
+
+namespace {
+
+/// Get the size of the given message on a serial MIDI connection, without
+/// running status.
+uint8_t getSize(MIDIMessage msg) {
+    if (msg.hasValidChannelMessageHeader())
+        return ChannelMessage(msg).hasTwoDataBytes() ? 3 : 2;
+    return SysCommonMessage(msg).getNumberOfDataBytes() + 1;
+}
+
+} // namespace
+
+void RateLimitedMIDI_Pipe::setRate(uint32_t bytesPerSecond, uint16_t burst) {
+    if (bytesPerSecond == 0)
+        usPerByte = 0; // unlimited
+    else
+        usPerByte = bytesPerSecond >= 1000000 ? 1 : 1000000 / bytesPerSecond;
+    burstTime = usPerByte * burst;
+}
+
+RateLimitedMIDI_Pipe::Priority
+RateLimitedMIDI_Pipe::getPriority(ChannelMessage msg) {
+    return CoalescingMIDI_Pipe::isCoalescable(msg) ? Continuous : Event;
+}
+
+bool RateLimitedMIDI_Pipe::fits(uint16_t bytes, unsigned long now) const {
+    long backlog = paidUntil - now;
+    if (backlog < 0)
+        backlog = 0;
+    return backlog + bytes * usPerByte <= burstTime;
+}
+
+void RateLimitedMIDI_Pipe::consume(uint16_t bytes, unsigned long now) {
+    if (long(paidUntil - now) < 0)
+        paidUntil = now;
+    paidUntil += bytes * usPerByte;
+}
+
+void RateLimitedMIDI_Pipe::send(Slot slot, unsigned long now) {
+    MIDIMessage msg = slot.getMessage();
+    consume(getSize(msg), now);
+    if (msg.hasValidChannelMessageHeader())
+        sourceMIDItoSink(ChannelMessage(msg));
+    else
+        sourceMIDItoSink(SysCommonMessage(msg));
+}
+
+void RateLimitedMIDI_Pipe::popEvent(unsigned long now) {
+    Slot slot = queue[queueStart];
+    queueStart = (queueStart + 1) % MIDI_RATE_LIMIT_QUEUE_SIZE;
+    --numQueued;
+    send(slot, now);
+}
+
+void RateLimitedMIDI_Pipe::popContinuous(unsigned long now) {
+    Slot slot = continuous[0];
+    --numContinuous;
+    for (uint8_t i = 0; i < numContinuous; ++i)
+        continuous[i] = continuous[i + 1];
+    send(slot, now);
+}
+
+void RateLimitedMIDI_Pipe::drain() {
+    unsigned long now = micros();
+    // Don't let the budget accumulate past the burst size
+    if (long(paidUntil - now) < 0)
+        paidUntil = now;
+    while (numQueued > 0) {
+        if (!fits(getSize(queue[queueStart].getMessage()), now))
+            return;
+        popEvent(now);
+    }
+    while (numContinuous > 0) {
+        if (!fits(getSize(continuous[0].getMessage()), now))
+            return;
+        popContinuous(now);
+    }
+}
+
+void RateLimitedMIDI_Pipe::enqueue(Slot slot) {
+    unsigned long now = micros();
+    if (numQueued == 0 && fits(getSize(slot.getMessage()), now))
+        return send(slot, now);
+    if (numQueued == MIDI_RATE_LIMIT_QUEUE_SIZE) {
+        popEvent(now);
+        ++numForced;
+    }
+    queue[(queueStart + numQueued) % MIDI_RATE_LIMIT_QUEUE_SIZE] = slot;
+    ++numQueued;
+    ++numDeferred;
+}
+
+void RateLimitedMIDI_Pipe::hold(Slot slot) {
+    unsigned long now = micros();
+    if (numQueued == 0 && numContinuous == 0 &&
+        fits(getSize(slot.getMessage()), now))
+        return send(slot, now);
+    // Pitch Bend and Channel Pressure have a single value per channel
+    bool perChannel = (slot.header & 0xF0) >= 0xD0;
+    for (uint8_t i = 0; i < numContinuous; ++i) {
+        Slot &held = continuous[i];
+        if (held.header == slot.header && held.cable == slot.cable &&
+            (perChannel || held.data1 == slot.data1)) {
+            held = slot;
+            ++numThinned;
+            return;
+        }
+    }
+    if (numContinuous == MIDI_COALESCING_SLOTS) {
+        popContinuous(now);
+        ++numForced;
+    }
+    continuous[numContinuous++] = slot;
+    ++numDeferred;
+}
+
+void RateLimitedMIDI_Pipe::mapForwardMIDI(ChannelMessage msg) {
+    drain();
+    if (getPriority(msg) == Continuous)
+        hold(Slot::from(msg));
+    else
+        enqueue(Slot::from(msg));
+}
+
+void RateLimitedMIDI_Pipe::mapForwardMIDI(SysExMessage msg) {
+    drain();
+    unsigned long now = micros();
+    // SysEx data can't be held, so the earlier events have to go first
+    while (numQueued > 0) {
+        popEvent(now);
+        ++numForced;
+    }
+    consume(msg.length, now);
+    sourceMIDItoSink(msg);
+}
+
+void RateLimitedMIDI_Pipe::mapForwardMIDI(SysCommonMessage msg) {
+    drain();
+    enqueue(Slot::from(msg));
+}
+
+void RateLimitedMIDI_Pipe::mapForwardMIDI(RealTimeMessage msg) {
+    consume(1, micros());
+    sourceMIDItoSink(msg);
+}
+
+void RateLimitedMIDI_Pipe::mapForwardMIDI(UMPMessage msg) {
+    UMPToMIDI1Translator translator;
+    translator.translate(msg);
+    translator.forEachMessage(ForwardTarget {this});
+}
+
+void RateLimitedMIDI_Pipe::mapForwardNow() {
+    drain();
+    sourceNowToSink();
+}
+
+END_CS_NAMESPACE
+
+#endif
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <Settings/SettingsWrapper.hpp>
+#if !DISABLE_PIPES
+
+#include "MIDI_Pipes.hpp"
+#include <AH/Containers/Updatable.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   A MIDI pipe that limits the number of bytes per second sent to its
+ *          sink, and sends the most timing-critical messages first.
+ *
+ * Connect one between a source and a slow MIDI interface, e.g. to keep
+ * a 5-pin DIN output from falling behind when the same messages are sent
+ * over USB as well:
+ *
+ * ~~~cpp
+ * RateLimitedMIDI_Pipe dinLimiter = RateLimitedMIDI_Pipe::DIN_BYTES_PER_SECOND;
+ * midimap >> dinLimiter >> din;
+ * ~~~
+ *
+ * The budget is a token bucket: bytes can be sent in bursts of at most
+ * @ref setRate "burst" bytes, and the bucket refills at the given rate.
+ * Messages are divided in three priority classes:
+ *
+ *  1. **Real-time**: always sent immediately, even if the budget is used up
+ *     (they still use it up).
+ *  2. **Events**: notes, program changes, (N)RPN, System Common and SysEx.
+ *     They are sent in order, and deferred when the budget is used up.
+ *  3. **Continuous**: Control Change, Pitch Bend and Pressure. They are only
+ *     sent when no events are waiting, and they are thinned: when a
+ *     controller changes again before its old value was sent, only the
+ *     latest value is kept (see @ref CoalescingMIDI_Pipe::isCoalescable).
+ *
+ * Because of the priorities, a Control Change may arrive after a Note that
+ * was sent after it.
+ *
+ * Deferred messages are sent from @ref update(), which is called
+ * automatically by `midimap.loop()`. If the queue or the table of continuous
+ * controllers is full, the oldest message is sent regardless of the budget.
+ * SysEx messages cannot be held, the waiting events are sent before them,
+ * and they are sent right away.
+ *
+ * Universal MIDI Packets are translated to MIDI 1.0 first, since a slow link
+ * is a MIDI 1.0 link.
+ *
+ * @ingroup MIDI_Routing
+ */
+class RateLimitedMIDI_Pipe : public MIDI_Pipe, public AH::Updatable<> {
+  public:
+    /// The byte rate of a 5-pin DIN MIDI connection (31250 baud, 10 bits per
+    /// byte).
+    constexpr static uint32_t DIN_BYTES_PER_SECOND = 3125;
+
+    /// The priority classes, highest priority first.
+    enum Priority : uint8_t {
+        RealTime,   ///< System Real-Time messages.
+        Event,      ///< Notes, Program Change, (N)RPN, System Common, SysEx.
+        Continuous, ///< Control Change, Pitch Bend, Pressure.
+    };
+
+    /**
+     * @brief   Create a rate limiter.
+     *
+     * @param   bytesPerSecond
+     *          The maximum average number of bytes per second, or zero to
+     *          pass all messages through without limiting the rate.
+     * @param   burst
+     *          The maximum number of bytes that can be sent at once.
+     */
+    RateLimitedMIDI_Pipe(uint32_t bytesPerSecond = DIN_BYTES_PER_SECOND,
+                         uint16_t burst = MIDI_RATE_LIMIT_BURST) {
+        setRate(bytesPerSecond, burst);
+    }
+
+    /// @see    RateLimitedMIDI_Pipe(uint32_t, uint16_t)
+    void setRate(uint32_t bytesPerSecond, uint16_t burst);
+
+    /// Does nothing.
+    void begin() override {}
+    /// Send the deferred messages the budget allows for.
+    void update() override { drain(); }
+
+    /// Get the priority class of the given message.
+    static Priority getPriority(ChannelMessage msg);
+
+    /// Get the number of messages that are currently deferred.
+    uint8_t getNumberOfPendingMessages() const {
+        return numQueued + numContinuous;
+    }
+    /// Get the number of messages that had to wait for the budget.
+    uint32_t getNumberOfDeferredMessages() const { return numDeferred; }
+    /// Get the number of continuous controller messages that were dropped
+    /// because a newer value arrived before they could be sent.
+    uint32_t getNumberOfThinnedMessages() const { return numThinned; }
+    /// Get the number of messages that were sent over budget because the
+    /// buffers were full.
+    uint32_t getNumberOfForcedMessages() const { return numForced; }
+
+  private:
+    /// A held System Common or Channel Voice message.
+    struct Slot {
+        uint8_t header;
+        uint8_t data1;
+        uint8_t data2;
+        uint8_t cable;
+        static Slot from(MIDIMessage msg) {
+            return {msg.header, msg.data1, msg.data2, msg.cable.getRaw()};
+        }
+        MIDIMessage getMessage() const {
+            return {header, data1, data2, Cable(cable)};
+        }
+    };
+
+    void mapForwardMIDI(ChannelMessage msg) override;
+    void mapForwardMIDI(SysExMessage msg) override;
+    void mapForwardMIDI(SysCommonMessage msg) override;
+    void mapForwardMIDI(RealTimeMessage msg) override;
+    void mapForwardMIDI(UMPMessage msg) override;
+    void mapForwardNow() override;
+
+    /// Passes translated messages to the right @ref mapForwardMIDI.
+    struct ForwardTarget {
+        RateLimitedMIDI_Pipe *pipe;
+        template <class Message>
+        void operator()(Message msg) const {
+            pipe->mapForwardMIDI(msg);
+        }
+    };
+
+    /// Check whether a message of the given size fits in the budget.
+    bool fits(uint16_t bytes, unsigned long now) const;
+    /// Use up the budget for a message of the given size.
+    void consume(uint16_t bytes, unsigned long now);
+    /// Consume the budget for the given message, and forward it.
+    void send(Slot slot, unsigned long now);
+
+    /// Send as many waiting messages as the budget allows.
+    void drain();
+    /// Queue an event, or send it if it's allowed to skip the queue.
+    void enqueue(Slot slot);
+    /// Hold the latest value of a continuous controller.
+    void hold(Slot slot);
+    /// Send and remove the oldest queued event.
+    void popEvent(unsigned long now);
+    /// Send and remove the oldest held continuous controller.
+    void popContinuous(unsigned long now);
+
+  private:
+    /// Deferred events, a circular buffer.
+    Slot queue[MIDI_RATE_LIMIT_QUEUE_SIZE];
+    /// Deferred continuous controllers, oldest first.
+    Slot continuous[MIDI_COALESCING_SLOTS];
+    uint8_t queueStart = 0;
+    uint8_t numQueued = 0;
+    uint8_t numContinuous = 0;
+
+    /// The time it takes to send one byte, in microseconds.
+    unsigned long usPerByte;
+    /// The time it takes to send a full burst, in microseconds.
+    unsigned long burstTime;
+    /// The time at which the bytes sent so far are fully paid for.
+    unsigned long paidUntil = 0;
+
+    uint32_t numDeferred = 0;
+    uint32_t numThinned = 0;
+    uint32_t numForced = 0;
+};
+
+END_CS_NAMESPACE
+
+#endif
@@ -1,5 +1,4 @@
 #include "SerialMIDI_Interface.hpp"
-#include <MIDI_Parsers/StreamPuller.hpp>
 
 #include "PicoUSBInit.hpp"
 
@@ -12,7 +11,30 @@ BEGIN_CS_NAMESPACE
 MIDIReadEvent StreamMIDI_Interface::read() {
     if (!ensure_usb_init(stream))
         return MIDIReadEvent::NO_MESSAGE;
-    return parser.pull(StreamPuller(stream));
+    if (batchIndex == batch.count) {
+        // Read all bytes that are available without blocking, and parse them
+        // in one go.
+        if (rawBegin == rawEnd) {
+            int available = stream.available();
+            size_t length = available < 0 ? 0 : available;
+            if (length > sizeof(rawBuffer))
+                length = sizeof(rawBuffer);
+            if (length > 0)
+                length = stream.readBytes(reinterpret_cast<char *>(rawBuffer),
+                                          length);
+            rawBegin = rawBuffer;
+            rawEnd = rawBuffer + length;
+        }
+        // Even if there are no new bytes, the parser might still have a
+        // stored byte to parse.
+        batch = parser.parse(rawBegin, rawEnd);
+        rawBegin = batch.next;
+        batchIndex = 0;
+        if (batch.count == 0)
+            return MIDIReadEvent::NO_MESSAGE;
+    }
+    message = batch.messages[batchIndex++];
+    return message.event;
 }
 
 void StreamMIDI_Interface::update() { MIDI_Interface::updateIncoming(this); }
@@ -22,15 +44,15 @@ void StreamMIDI_Interface::update() { MIDI_Interface::updateIncoming(this); }
 // Retrieving the received messages
 
 ChannelMessage StreamMIDI_Interface::getChannelMessage() const {
-    return parser.getChannelMessage();
+    return message.getChannelMessage();
 }
 
 SysCommonMessage StreamMIDI_Interface::getSysCommonMessage() const {
-    return parser.getSysCommonMessage();
+    return message.getSysCommonMessage();
 }
 
 RealTimeMessage StreamMIDI_Interface::getRealTimeMessage() const {
-    return parser.getRealTimeMessage();
+    return message.getRealTimeMessage();
 }
 
 SysExMessage StreamMIDI_Interface::getSysExMessage() const {
@@ -57,6 +57,17 @@ class StreamMIDI_Interface : public MIDI_Interface {
   protected:
     Stream &stream;
     SerialMIDI_Parser parser;
+
+  private:
+    /// Bytes read from the stream that haven't been parsed yet.
+    uint8_t rawBuffer[SERIAL_MIDI_READ_BUFFER_SIZE];
+    const uint8_t *rawBegin = rawBuffer;
+    const uint8_t *rawEnd = rawBuffer;
+    /// Messages parsed from @ref rawBuffer that haven't been read yet.
+    SerialMIDI_Parser::Batch batch;
+    uint8_t batchIndex = 0;
+    /// The message returned by the last call to @ref read.
+    SerialMIDI_Parser::Message message {MIDIReadEvent::NO_MESSAGE, 0, 0, 0};
 };
 
 // -------------------------------------------------------------------------- //
@@ -0,0 +1,110 @@
+#include "StreamUMP_Interface.hpp"
+#if !DISABLE_PIPES
+
+#include "PicoUSBInit.hpp"
+
+BEGIN_CS_NAMESPACE
+
+// -------------------------------------------------------------------------- //
+
+// Reading packets
+
+bool StreamUMP_Interface::readPacket() {
+    while (true) {
+        if (rawBegin == rawEnd) {
+            int available = stream.available();
+            size_t length = available < 0 ? 0 : available;
+            if (length > sizeof(rawBuffer))
+                length = sizeof(rawBuffer);
+            if (length > 0)
+                length = stream.readBytes(reinterpret_cast<char *>(rawBuffer),
+                                          length);
+            if (length == 0)
+                return false;
+            rawBegin = rawBuffer;
+            rawEnd = rawBuffer + length;
+        }
+        if (parser.parse(rawBegin, rawEnd))
+            return true;
+    }
+}
+
+void StreamUMP_Interface::dispatchPacket() {
+    UMPMessage msg = parser.getMessage();
+    if (msg.getMessageType() == UMPMessageType::Data64) {
+        auto status = static_cast<UMPSysExStatus>(msg.getStatus() >> 4);
+        uint16_t groupBit = 1u << msg.getCable().getRaw();
+        if (status == UMPSysExStatus::Start ||
+            status == UMPSysExStatus::Continue)
+            sysexActive |= groupBit;
+        else
+            sysexActive &= ~groupBit;
+    }
+    onUMPMessage(msg);
+}
+
+void StreamUMP_Interface::update() {
+    if (!ensure_usb_init(stream))
+        return;
+    if (getStaller() == this)
+        unstall(this);
+    int16_t size_rem = 512 * 3 / 4; // Don't keep on reading for too long
+    while (size_rem > 0 && readPacket()) {
+        dispatchPacket();
+        size_rem -= 4 * parser.getMessage().getNumberOfWords();
+    }
+    // The other sources have to wait until the SysEx message is complete
+    if (sysexActive != 0)
+        stall(this);
+}
+
+void StreamUMP_Interface::handleStall() {
+    const char *staller_name = getStallerName();
+    DEBUGFN(F("Handling stall. Cause: ") << staller_name);
+    unstall(this);
+
+    unsigned long startTime = millis();
+    while (millis() - startTime < SYSEX_CHUNK_TIMEOUT) {
+        if (!readPacket())
+            continue;
+        dispatchPacket();
+        if (parser.getMessage().getMessageType() == UMPMessageType::Data64) {
+            startTime = millis(); // reset timeout
+            if (sysexActive == 0)
+                return;
+        }
+    }
+    DEBUGFN(F("Warning: Unable to un-stall pipes. Cause: ") << staller_name);
+    static_cast<void>(staller_name);
+}
+
+// -------------------------------------------------------------------------- //
+
+// Sending packets
+
+void StreamUMP_Interface::sendUMPImpl(UMPMessage msg) {
+    if (!ensure_usb_init(stream))
+        return;
+    uint8_t data[8];
+    stream.write(data, msg.toBytes(data));
+}
+
+void StreamUMP_Interface::sendChannelMessageImpl(ChannelMessage msg) {
+    translator.translate(msg, [this](UMPMessage p) { sendUMPImpl(p); });
+}
+
+void StreamUMP_Interface::sendSysCommonImpl(SysCommonMessage msg) {
+    translator.translate(msg, [this](UMPMessage p) { sendUMPImpl(p); });
+}
+
+void StreamUMP_Interface::sendSysExImpl(SysExMessage msg) {
+    translator.translate(msg, [this](UMPMessage p) { sendUMPImpl(p); });
+}
+
+void StreamUMP_Interface::sendRealTimeImpl(RealTimeMessage msg) {
+    translator.translate(msg, [this](UMPMessage p) { sendUMPImpl(p); });
+}
+
+END_CS_NAMESPACE
+
+#endif
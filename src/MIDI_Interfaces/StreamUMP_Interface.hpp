@@ -0,0 +1,91 @@
+#pragma once
+
+#include <Settings/SettingsWrapper.hpp>
+#if !DISABLE_PIPES
+
+#include "MIDI_Interface.hpp"
+#include <AH/Arduino-Wrapper.h> // Stream
+#include <MIDI_Parsers/UMPTranslator.hpp>
+#include <MIDI_Parsers/UMP_Parser.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   A MIDI 2.0 interface that sends and receives Universal MIDI
+ *          Packets over a Stream, in network byte order (big-endian).
+ *
+ * Packets that are sent using `send(UMPMessage)` or that arrive through the
+ * pipes (e.g. a 32-bit Control Change from a @ref CCPotentiometer32) are
+ * written as they are. MIDI 1.0 messages are translated to packets first,
+ * using MIDI 2.0 Channel Voice messages by default, see @ref setProtocol.
+ *
+ * Incoming packets are sent down the pipes as they are: MIDI 2.0 sinks
+ * receive them unchanged, MIDI 1.0 sinks (including the MIDI input elements)
+ * translate them to MIDI 1.0 messages. The pipes are stalled while a System
+ * Exclusive message is incomplete, like for other interfaces.
+ *
+ * Since any Stream can be used, the interface can be tested on a computer,
+ * by feeding it a recorded UMP stream.
+ *
+ * @ingroup MIDIInterfaces
+ */
+class StreamUMP_Interface : public MIDI_Interface {
+  public:
+    /// Constructor.
+    /// @param   stream
+    ///          Reference to the Stream interface to read and send packets
+    ///          from/to.
+    /// @param   protocol
+    ///          The protocol for Channel Voice messages that are sent as
+    ///          MIDI 1.0 messages.
+    StreamUMP_Interface(Stream &stream,
+                        UMPProtocol protocol = UMPProtocol::MIDI2)
+        : stream(stream), translator(protocol) {}
+
+    /// Read, parse and dispatch the incoming packets.
+    void update() override;
+
+    /// Select the protocol for Channel Voice messages that are sent as MIDI 1.0
+    /// messages.
+    void setProtocol(UMPProtocol protocol) { translator.setProtocol(protocol); }
+    /// Get the protocol for Channel Voice messages that are sent as MIDI 1.0
+    /// messages.
+    UMPProtocol getProtocol() const { return translator.getProtocol(); }
+
+  protected:
+    void sendChannelMessageImpl(ChannelMessage) override;
+    void sendSysCommonImpl(SysCommonMessage) override;
+    void sendSysExImpl(SysExMessage) override;
+    void sendRealTimeImpl(RealTimeMessage) override;
+    void sendUMPImpl(UMPMessage) override;
+    void sendNowImpl() override {}
+
+  protected:
+    void handleStall() override;
+#ifdef DEBUG_OUT
+    const char *getName() const override { return "ump"; }
+#endif
+
+  private:
+    /// Read bytes until a packet is complete.
+    /// @return True if a packet is available from the parser.
+    bool readPacket();
+    /// Send the latest packet down the pipe.
+    void dispatchPacket();
+
+  protected:
+    Stream &stream;
+
+  private:
+    UMP_Parser parser;
+    MIDI1ToUMPTranslator translator;
+    uint8_t rawBuffer[32];
+    const uint8_t *rawBegin = rawBuffer;
+    const uint8_t *rawEnd = rawBuffer;
+    /// One bit per group, set while an incoming SysEx message is incomplete.
+    uint16_t sysexActive = 0;
+};
+
+END_CS_NAMESPACE
+
+#endif
@@ -0,0 +1,24 @@
+#include "SysExStreamConsumer.hpp"
+#include "MIDI_Interface.hpp"
+#include <string.h>
+
+BEGIN_CS_NAMESPACE
+
+SysExStreamConsumer::SysExStreamConsumer(const uint8_t *prefix,
+                                         uint8_t length)
+    : prefixLength(length < MaxPrefixLength ? length : MaxPrefixLength) {
+    memcpy(this->prefix, prefix, prefixLength);
+}
+
+SysExStreamConsumer::~SysExStreamConsumer() {
+    if (iface != nullptr)
+        iface->removeSysExConsumer(*this);
+}
+
+bool SysExStreamConsumer::matches(SysExMessage chunk) const {
+    return chunk.length > prefixLength &&
+           chunk.data[0] == uint8_t(MIDIMessageType::SysExStart) &&
+           memcmp(chunk.data + 1, prefix, prefixLength) == 0;
+}
+
+END_CS_NAMESPACE
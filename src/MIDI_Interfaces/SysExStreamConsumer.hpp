@@ -0,0 +1,103 @@
+#pragma once
+
+#include <AH/Containers/LinkedList.hpp>
+#include <MIDI_Parsers/MIDI_MessageTypes.hpp>
+#include <Settings/SettingsWrapper.hpp>
+
+BEGIN_CS_NAMESPACE
+
+class MIDI_Interface;
+
+/**
+ * @brief   Receives long System Exclusive messages with a given prefix
+ *          (e.g. a manufacturer ID) chunk by chunk, as they are parsed.
+ *
+ * Normally, a SysEx message that doesn't fit in the parser's buffer is
+ * delivered in chunks to the MIDI pipes and callbacks, and the pipes are
+ * stalled until the final chunk arrives, so no other messages can be sent
+ * through them during the whole transfer. Messages that start with the prefix
+ * of a consumer that was added to the MIDI interface using
+ * @ref MIDI_Interface::addSysExConsumer are handed to that consumer instead,
+ * and other incoming messages are dispatched normally in between the chunks.
+ *
+ * The chunks point directly into the buffer of the parser, they are only
+ * valid during the call to @ref onSysExChunk. The first chunk starts with the
+ * SysEx Start byte (0xF0) and the last chunk ends with the SysEx End byte
+ * (0xF7). If the sender aborts a message, a chunk with the @ref Start flag may
+ * follow without a chunk with the @ref End flag.
+ *
+ * Streamed messages are not sent to the MIDI pipes or callbacks.
+ *
+ * A consumer can only be added to one MIDI interface at a time. It removes
+ * itself from that interface when it is destroyed.
+ *
+ * @ingroup MIDIInterfaces
+ */
+class SysExStreamConsumer : public DoublyLinkable<SysExStreamConsumer> {
+  public:
+    /// Flags describing the position of a chunk in its message.
+    enum Flags : uint8_t {
+        Continue = 0, ///< Neither the first nor the last chunk.
+        Start = 1,    ///< The first chunk, starts with 0xF0.
+        End = 2,      ///< The last chunk, ends with 0xF7.
+    };
+
+    /// The maximum length of the prefix.
+    constexpr static uint8_t MaxPrefixLength = 4;
+
+    /**
+     * @brief   Create a consumer for the messages that start with the given
+     *          bytes (not including the SysEx Start byte).
+     *
+     * @param   prefix
+     *          The first bytes of the message after 0xF0, e.g. the
+     *          manufacturer ID (one byte, or three bytes starting with 0x00),
+     *          optionally followed by a device or model ID. At most
+     *          @ref MaxPrefixLength bytes are used.
+     * @param   length
+     *          The length of the prefix.
+     */
+    SysExStreamConsumer(const uint8_t *prefix, uint8_t length);
+    /// Create a consumer for a one-byte manufacturer ID.
+    SysExStreamConsumer(uint8_t manufacturerID)
+        : SysExStreamConsumer(&manufacturerID, 1) {}
+
+    /// Remove the consumer from the MIDI interface it was added to.
+    virtual ~SysExStreamConsumer();
+
+    /**
+     * @brief   Called for every chunk of a message that starts with the
+     *          prefix.
+     *
+     * @param   iface
+     *          The MIDI interface the message was received on.
+     * @param   chunk
+     *          The data of the chunk, and the cable it was received on.
+     * @param   flags
+     *          A combination of @ref Start and @ref End, or @ref Continue.
+     */
+    virtual void onSysExChunk(MIDI_Interface &iface, SysExMessage chunk,
+                              uint8_t flags) = 0;
+
+    /// Check whether the given first chunk of a message starts with the
+    /// prefix.
+    bool matches(SysExMessage chunk) const;
+
+    /// Check whether a message is being streamed to this consumer on the
+    /// given cable.
+    bool isStreaming(Cable cable) const {
+        return activeCables & (1u << cable.getRaw());
+    }
+
+  private:
+    friend class MIDI_Interface;
+
+    /// The MIDI interface this consumer was added to.
+    MIDI_Interface *iface = nullptr;
+    uint8_t prefix[MaxPrefixLength];
+    uint8_t prefixLength;
+    /// The cables with an unfinished streamed message, one bit per cable.
+    uint16_t activeCables = 0;
+};
+
+END_CS_NAMESPACE
@@ -16,6 +16,17 @@ class USBHostMIDIBackend {
     using MIDIUSBPacket_t = AH::Array<uint8_t, 4>;
     MIDIUSBPacket_t read() { return u32_to_bytes(backend.read()); }
     void write(MIDIUSBPacket_t data) { backend.write(bytes_to_u32(data)); }
+    size_t read(uint32_t *dst, size_t n) {
+        size_t i = 0;
+        for (; i < n; ++i)
+            if ((dst[i] = backend.read()) == 0)
+                break;
+        return i;
+    }
+    void write(const uint32_t *src, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            backend.write(src[i]);
+    }
     void sendNow() { backend.send_now(); }
     bool preferImmediateSend() { return false; }
 
@@ -8,6 +8,7 @@
 #else
 #include <cstdint> // STL
 #endif
+#include <Def/TypeTraits.hpp>
 #include <Settings/NamespaceSettings.hpp>
 
 #ifdef ARDUINO_ARCH_ESP32
@@ -40,6 +41,61 @@ inline uint32_t bytes_to_u32(AH::Array<uint8_t, 4> b) {
            (uint32_t(b.data[3]) << 24);  //
 }
 
+template <class, class = void>
+struct has_method_read_packets : std::false_type {};
+
+template <class T>
+struct has_method_read_packets<
+    T, void_t<decltype(std::declval<T>().read(std::declval<uint32_t *>(),
+                                              size_t()))>> : std::true_type {};
+
+template <class, class = void>
+struct has_method_write_packets : std::false_type {};
+
+template <class T>
+struct has_method_write_packets<
+    T, void_t<decltype(std::declval<T>().write(
+           std::declval<const uint32_t *>(), size_t()))>> : std::true_type {};
+
+/// Read at most @p n USB MIDI packets from the given backend into @p dst.
+/// Uses the backend's multi-packet `read(uint32_t *, size_t)` method if it has
+/// one, otherwise, single packets are read until the backend runs out.
+/// @return The number of packets read.
+template <class Backend>
+typename std::enable_if<has_method_read_packets<Backend>::value, size_t>::type
+read_packets(Backend &backend, uint32_t *dst, size_t n) {
+    return backend.read(dst, n);
+}
+
+template <class Backend>
+typename std::enable_if<!has_method_read_packets<Backend>::value, size_t>::type
+read_packets(Backend &backend, uint32_t *dst, size_t n) {
+    size_t i = 0;
+    for (; i < n; ++i) {
+        auto packet = backend.read();
+        if (packet[0] == 0x00)
+            break;
+        dst[i] = bytes_to_u32(packet);
+    }
+    return i;
+}
+
+/// Write @p n USB MIDI packets from @p src to the given backend. Uses the
+/// backend's multi-packet `write(const uint32_t *, size_t)` method if it has
+/// one, otherwise, the packets are written one by one.
+template <class Backend>
+typename std::enable_if<has_method_write_packets<Backend>::value>::type
+write_packets(Backend &backend, const uint32_t *src, size_t n) {
+    backend.write(src, n);
+}
+
+template <class Backend>
+typename std::enable_if<!has_method_write_packets<Backend>::value>::type
+write_packets(Backend &backend, const uint32_t *src, size_t n) {
+    for (size_t i = 0; i < n; ++i)
+        backend.write(u32_to_bytes(src[i]));
+}
+
 END_CS_NAMESPACE
 
 #ifdef ARDUINO
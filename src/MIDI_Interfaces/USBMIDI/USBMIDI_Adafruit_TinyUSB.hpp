@@ -32,6 +32,26 @@ struct Adafruit_TinyUSB_USBDeviceMIDIBackend {
         if (TinyUSBDevice.mounted())
             backend.writePacket(packet.data);
     }
+    size_t read(uint32_t *dst, size_t n) {
+#ifdef TINYUSB_NEED_POLLING_TASK
+        TinyUSBDevice.task();
+#endif
+        if (!TinyUSBDevice.mounted())
+            return 0;
+        size_t i = 0;
+        for (MIDIUSBPacket_t packet; i < n; ++i) {
+            if (!backend.readPacket(packet.data))
+                break;
+            dst[i] = bytes_to_u32(packet);
+        }
+        return i;
+    }
+    void write(const uint32_t *src, size_t n) {
+        if (!TinyUSBDevice.mounted())
+            return;
+        for (size_t i = 0; i < n; ++i)
+            backend.writePacket(u32_to_bytes(src[i]).data);
+    }
     void sendNow() {
         if (TinyUSBDevice.mounted())
             backend.flush();
@@ -25,6 +25,25 @@ struct ESP32_USBDeviceMIDIBackend {
         midiEventPacket_t packet {p[0], p[1], p[2], p[3]};
         backend.writePacket(&packet);
     }
+    /// Read at most n packets. Return the number of packets read.
+    size_t read(uint32_t *dst, size_t n) {
+        size_t i = 0;
+        for (midiEventPacket_t packet; i < n; ++i) {
+            if (!backend.readPacket(&packet))
+                break;
+            dst[i] = bytes_to_u32(packet.header, packet.byte1, packet.byte2,
+                                  packet.byte3);
+        }
+        return i;
+    }
+    /// Write n packets to the output buffer.
+    void write(const uint32_t *src, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            auto p = u32_to_bytes(src[i]);
+            midiEventPacket_t packet {p[0], p[1], p[2], p[3]};
+            backend.writePacket(&packet);
+        }
+    }
     /// Transmit the output buffer immediately (not implemented).
     void sendNow() {}
     /// No explicit call to sendNow is required.
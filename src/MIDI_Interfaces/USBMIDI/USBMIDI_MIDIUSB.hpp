@@ -2,6 +2,7 @@
 #include <Settings/NamespaceSettings.hpp>
 
 #include <MIDIUSB.h>
+#include <string.h>
 
 BEGIN_CS_NAMESPACE
 
@@ -16,6 +17,21 @@ struct MIDIUSB_USBDeviceMIDIBackend {
         midiEventPacket_t msg{d.data[0], d.data[1], d.data[2], d.data[3]};
         MidiUSB.sendMIDI(msg);
     }
+    /// Write multiple packets using a single USB transfer per endpoint buffer
+    /// instead of one transfer per packet.
+    void write(const uint32_t *src, size_t n) {
+        uint8_t buffer[64];
+        while (n > 0) {
+            size_t count = n < sizeof(buffer) / 4 ? n : sizeof(buffer) / 4;
+            for (size_t i = 0; i < count; ++i) {
+                auto packet = u32_to_bytes(src[i]);
+                memcpy(buffer + 4 * i, packet.data, 4);
+            }
+            MidiUSB.write(buffer, 4 * count);
+            src += count;
+            n -= count;
+        }
+    }
     void sendNow() { MidiUSB.flush(); }
     bool preferImmediateSend() { return true; }
 };
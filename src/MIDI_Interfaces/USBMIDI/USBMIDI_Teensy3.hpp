@@ -8,6 +8,8 @@ struct Teensy3_USBDeviceMIDIBackend {
     using MIDIUSBPacket_t = AH::Array<uint8_t, 4>;
     MIDIUSBPacket_t read();
     void write(MIDIUSBPacket_t data);
+    size_t read(uint32_t *dst, size_t n);
+    void write(const uint32_t *src, size_t n);
     void sendNow();
     bool preferImmediateSend();
 };
@@ -30,6 +32,20 @@ inline void Teensy3_USBDeviceMIDIBackend::write(MIDIUSBPacket_t data) {
     usb_midi_write_packed(bytes_to_u32(data));
 }
 
+inline size_t Teensy3_USBDeviceMIDIBackend::read(uint32_t *dst, size_t n) {
+    size_t i = 0;
+    for (; i < n; ++i)
+        if ((dst[i] = usb_midi_read_message()) == 0)
+            break;
+    return i;
+}
+
+inline void Teensy3_USBDeviceMIDIBackend::write(const uint32_t *src,
+                                                size_t n) {
+    for (size_t i = 0; i < n; ++i)
+        usb_midi_write_packed(src[i]);
+}
+
 inline void Teensy3_USBDeviceMIDIBackend::sendNow() { usb_midi_flush_output(); }
 
 inline bool Teensy3_USBDeviceMIDIBackend::preferImmediateSend() {
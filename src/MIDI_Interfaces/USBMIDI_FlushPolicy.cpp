@@ -0,0 +1,26 @@
+#include "USBMIDI_FlushPolicy.hpp"
+
+BEGIN_CS_NAMESPACE
+
+bool AdaptiveUSBMIDI_FlushPolicy::onMessage(uint32_t pending) {
+    unsigned long now = micros();
+    if (!waiting) {
+        // The first message after a quiet period is sent immediately
+        if (now - lastFlush >= deadline)
+            return true;
+        waiting = true;
+        firstPending = now;
+    }
+    return pending >= eventsPerPacket || now - firstPending >= deadline;
+}
+
+bool AdaptiveUSBMIDI_FlushPolicy::onPoll(uint32_t) {
+    return waiting && micros() - firstPending >= deadline;
+}
+
+void AdaptiveUSBMIDI_FlushPolicy::onFlush() {
+    lastFlush = micros();
+    waiting = false;
+}
+
+END_CS_NAMESPACE
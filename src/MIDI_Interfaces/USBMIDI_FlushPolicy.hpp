@@ -0,0 +1,118 @@
+#pragma once
+
+#include <AH/Arduino-Wrapper.h> // micros
+#include <Settings/SettingsWrapper.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   Decides when a USB MIDI interface transmits the events it has
+ *          buffered.
+ *
+ * Sending every MIDI message in its own USB packet gives the lowest latency,
+ * but wastes most of the bandwidth when many messages are sent at once.
+ * Buffering the messages until the endpoint buffer is full makes better use
+ * of the bus, but delays isolated messages. A flush policy makes that
+ * trade-off, see @ref GenericUSBMIDI_Interface::setFlushPolicy.
+ *
+ * @ingroup MIDIInterfaces
+ */
+class USBMIDI_FlushPolicy {
+  public:
+    virtual ~USBMIDI_FlushPolicy() = default;
+
+    /**
+     * @brief   Called after a MIDI message was written to the backend.
+     * @param   pending
+     *          The number of USB MIDI events written since the last flush,
+     *          including the ones of this message.
+     * @return  True if the events should be transmitted now.
+     */
+    virtual bool onMessage(uint32_t pending) = 0;
+    /**
+     * @brief   Called periodically (from `update()`) while there are events
+     *          that haven't been transmitted yet.
+     * @param   pending
+     *          The number of USB MIDI events written since the last flush.
+     * @return  True if the events should be transmitted now.
+     */
+    virtual bool onPoll(uint32_t pending) = 0;
+    /// Called after the buffered events were transmitted, either because the
+    /// policy asked for it, or because of an explicit call to `sendNow()`.
+    virtual void onFlush() {}
+};
+
+/**
+ * @brief   Flush policy similar to Nagle's algorithm: a message that's sent
+ *          after a quiet period is transmitted immediately, messages that
+ *          follow it shortly after are buffered until a full USB packet can
+ *          be sent, or until a deadline expires.
+ *
+ * A single Note On is delivered without delay, while a burst of hundreds of
+ * Control Change messages (e.g. after switching banks) is sent in full USB
+ * packets, and no message is delayed by more than the deadline.
+ *
+ * @note    The deadline is only checked when a message is sent, or when the
+ *          interface is updated, so `update()` should be called often.
+ *
+ * @ingroup MIDIInterfaces
+ */
+class AdaptiveUSBMIDI_FlushPolicy : public USBMIDI_FlushPolicy {
+  public:
+    /**
+     * @param   deadline
+     *          The maximum time in microseconds that a message is kept in
+     *          the buffer. Also the length of the quiet period after which a
+     *          message is sent immediately.
+     * @param   eventsPerPacket
+     *          The number of USB MIDI events that fit in one USB packet, 16
+     *          for a 64-byte full-speed endpoint.
+     */
+    AdaptiveUSBMIDI_FlushPolicy(
+        unsigned long deadline = USB_MIDI_FLUSH_DEADLINE,
+        uint16_t eventsPerPacket = USB_MIDI_EVENTS_PER_PACKET)
+        : deadline(deadline), eventsPerPacket(eventsPerPacket),
+          lastFlush(micros() - deadline) {}
+
+    bool onMessage(uint32_t pending) override;
+    bool onPoll(uint32_t pending) override;
+    void onFlush() override;
+
+    /// Set the maximum time in microseconds that a message is kept in the
+    /// buffer.
+    void setDeadline(unsigned long deadline) { this->deadline = deadline; }
+    /// Get the maximum time in microseconds that a message is kept in the
+    /// buffer.
+    unsigned long getDeadline() const { return deadline; }
+
+  private:
+    unsigned long deadline;
+    uint16_t eventsPerPacket;
+    /// Time of the last flush, to detect quiet periods.
+    unsigned long lastFlush;
+    /// Time of the first message that was buffered since the last flush.
+    unsigned long firstPending = 0;
+    /// Whether there are buffered messages.
+    bool waiting = false;
+};
+
+/**
+ * @brief   Number of USB MIDI events and USB packets sent by a USB MIDI
+ *          interface.
+ *
+ * The ratio of the two is the average number of events carried by each
+ * packet: close to one when every message is flushed immediately, and close
+ * to the capacity of the endpoint for large bursts of buffered messages.
+ *
+ * @ingroup MIDIInterfaces
+ */
+struct USBMIDI_FlushStats {
+    /// The number of 4-byte USB MIDI event packets written to the backend.
+    uint32_t events = 0;
+    /// The (estimated) number of USB packets these events were transmitted
+    /// in. Events that are transmitted because of a timeout in the backend
+    /// are counted when the interface flushes next.
+    uint32_t packets = 0;
+};
+
+END_CS_NAMESPACE
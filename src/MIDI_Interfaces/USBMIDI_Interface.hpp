@@ -2,6 +2,7 @@
 
 #include "MIDI_Interface.hpp"
 #include "USBMIDI/USBMIDI.hpp"
+#include "USBMIDI_FlushPolicy.hpp"
 #include "USBMIDI_Sender.hpp"
 #include <AH/Error/Error.hpp>
 #include <AH/Teensy/TeensyUSBTypes.hpp>
@@ -36,7 +37,10 @@ class GenericUSBMIDI_Interface : public MIDI_Interface {
     void sendSysCommonImpl(SysCommonMessage) override;
     void sendSysExImpl(SysExMessage) override;
     void sendRealTimeImpl(RealTimeMessage) override;
-    void sendNowImpl() override { backend.sendNow(); }
+    void sendNowImpl() override {
+        flushPackets();
+        transmit();
+    }
 
   private:
 #if !DISABLE_PIPES
@@ -87,22 +91,71 @@ class GenericUSBMIDI_Interface : public MIDI_Interface {
     Backend backend;
 
   private:
-    /// Functor to send USB MIDI packets.
+    /// Functor to send USB MIDI packets. The packets are collected in
+    /// @ref txBuffer, and written to the backend all at once. If the buffer
+    /// is full, its packets are written to the backend early, even during a
+    /// transaction.
     struct Sender {
         GenericUSBMIDI_Interface *iface;
         void operator()(Cable cn, MIDICodeIndexNumber cin, uint8_t d0,
                         uint8_t d1, uint8_t d2) {
             uint8_t cn_cin = (cn.getRaw() << 4) | uint8_t(cin);
-            iface->backend.write({cn_cin, d0, d1, d2});
+            if (iface->txCount == USB_MIDI_PACKET_BATCH_SIZE)
+                iface->flushPackets(); // doesn't transmit
+            iface->txBuffer[iface->txCount++] =
+                bytes_to_u32(cn_cin, d0, d1, d2);
+        }
+    };
+    /// Functor to write USB MIDI packets to the backend directly, without
+    /// the packets that are waiting in @ref txBuffer.
+    struct DirectSender {
+        GenericUSBMIDI_Interface *iface;
+        void operator()(Cable cn, MIDICodeIndexNumber cin, uint8_t d0,
+                        uint8_t d1, uint8_t d2) {
+            uint8_t cn_cin = (cn.getRaw() << 4) | uint8_t(cin);
+            uint32_t packet = bytes_to_u32(cn_cin, d0, d1, d2);
+            write_packets(iface->backend, &packet, 1);
+            ++iface->pendingEvents;
+            ++iface->stats.events;
         }
     };
     /// @}
 
+  private:
+    /// Write the packets in @ref txBuffer to the backend.
+    void flushPackets() {
+        write_packets(backend, txBuffer, txCount);
+        pendingEvents += txCount;
+        stats.events += txCount;
+        txCount = 0;
+    }
+    /// Transmit the packets that were written to the backend.
+    void transmit();
+    /// Hand the packets of a message to the backend, unless a transaction is
+    /// active, and transmit them if the flush policy asks for it.
+    void endMessage();
+
   private:
     /// Parses USB packets into MIDI messages.
     USBMIDI_Parser parser;
     /// Sends USB MIDI messages.
     USBMIDI_Sender sender;
+    /// Packets read from the backend that haven't been parsed yet.
+    uint32_t rxBuffer[USB_MIDI_PACKET_BATCH_SIZE];
+    /// Index of the first unparsed packet in @ref rxBuffer.
+    uint8_t rxIndex = 0;
+    /// Number of packets in @ref rxBuffer.
+    uint8_t rxCount = 0;
+    /// Packets that haven't been written to the backend yet.
+    uint32_t txBuffer[USB_MIDI_PACKET_BATCH_SIZE];
+    /// Number of packets in @ref txBuffer.
+    uint8_t txCount = 0;
+    /// Number of packets written to the backend since the last transmission.
+    uint32_t pendingEvents = 0;
+    /// @see setFlushPolicy()
+    USBMIDI_FlushPolicy *flushPolicy = nullptr;
+    /// @see getFlushStats()
+    USBMIDI_FlushStats stats;
     /// @see neverSendImmediately()
     bool alwaysSendImmediately_ = true;
 
@@ -123,9 +176,33 @@ class GenericUSBMIDI_Interface : public MIDI_Interface {
     /// increase latency when used incorrectly.
     void neverSendImmediately() { alwaysSendImmediately_ = false; }
     /// Send the USB packets immediately after sending a MIDI message.
+    /// Packets sent during a transaction are still buffered until the end of
+    /// the transaction (see @ref midimap_::setTransactionMode).
+    /// @note   Only @ref USB_MIDI_PACKET_BATCH_SIZE packets can be held back.
+    ///         The packets of longer transactions are handed to the backend
+    ///         in parts. Backends that buffer their writes until `sendNow()`
+    ///         (e.g. Teensy) still transmit them together, but the `MIDIUSB`
+    ///         backend may transmit the first parts before the transaction
+    ///         ends.
     /// @see @ref neverSendImmediately()
     void alwaysSendImmediately() { alwaysSendImmediately_ = true; }
 
+    /// Use the given policy to decide when to transmit the buffered USB
+    /// packets, instead of sending them immediately or never. Packets sent
+    /// during a transaction are still buffered until the end of the
+    /// transaction. Real-time messages are always sent immediately.
+    /// Pass `nullptr` to go back to the behavior selected by
+    /// @ref alwaysSendImmediately() and @ref neverSendImmediately().
+    /// @see    AdaptiveUSBMIDI_FlushPolicy
+    void setFlushPolicy(USBMIDI_FlushPolicy *policy) { flushPolicy = policy; }
+    /// Get the flush policy, or `nullptr` if none is used.
+    USBMIDI_FlushPolicy *getFlushPolicy() const { return flushPolicy; }
+
+    /// Get the number of USB MIDI events and USB packets sent so far.
+    USBMIDI_FlushStats getFlushStats() const { return stats; }
+    /// Reset the counters returned by @ref getFlushStats().
+    void resetFlushStats() { stats = {}; }
+
     /// @}
 };
 
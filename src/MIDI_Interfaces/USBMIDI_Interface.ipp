@@ -1,5 +1,4 @@
 #include <Def/TypeTraits.hpp>
-#include <MIDI_Parsers/LambdaPuller.hpp>
 
 BEGIN_CS_NAMESPACE
 
@@ -8,11 +7,19 @@ BEGIN_CS_NAMESPACE
 
 template <class Backend>
 MIDIReadEvent GenericUSBMIDI_Interface<Backend>::read() {
-    auto pullpacket = [this](typename Backend::MIDIUSBPacket_t &packet) {
-        packet = backend.read();
-        return packet[0] != 0x00;
-    };
-    return parser.pull(LambdaPuller(std::move(pullpacket)));
+    while (true) {
+        // Parse the packets that are left in the buffer
+        const uint32_t *packet = rxBuffer + rxIndex;
+        MIDIReadEvent evt = parser.parse(packet, rxBuffer + rxCount);
+        rxIndex = packet - rxBuffer;
+        if (evt != MIDIReadEvent::NO_MESSAGE)
+            return evt;
+        // Refill the buffer with as many packets as the backend has available
+        rxIndex = 0;
+        rxCount = read_packets(backend, rxBuffer, USB_MIDI_PACKET_BATCH_SIZE);
+        if (rxCount == 0)
+            return MIDIReadEvent::NO_MESSAGE;
+    }
 }
 
 template <class Backend>
@@ -24,6 +31,9 @@ void GenericUSBMIDI_Interface<Backend>::begin() {
 
 template <class Backend>
 void GenericUSBMIDI_Interface<Backend>::update() {
+    if (flushPolicy && pendingEvents > 0 && !inTransaction() &&
+        flushPolicy->onPoll(pendingEvents))
+        transmit();
     MIDI_Interface::updateIncoming(this);
 }
 
@@ -54,34 +64,54 @@ SysExMessage GenericUSBMIDI_Interface<Backend>::getSysExMessage() const {
 // Sending MIDI
 // -----------------------------------------------------------------------------
 
+template <class Backend>
+void GenericUSBMIDI_Interface<Backend>::transmit() {
+    backend.sendNow();
+    // Full packets are sent by the backend as soon as the buffer fills up
+    stats.packets += (pendingEvents + USB_MIDI_EVENTS_PER_PACKET - 1) /
+                     USB_MIDI_EVENTS_PER_PACKET;
+    pendingEvents = 0;
+    if (flushPolicy)
+        flushPolicy->onFlush();
+}
+
+template <class Backend>
+void GenericUSBMIDI_Interface<Backend>::endMessage() {
+    if (inTransaction())
+        return;
+    flushPackets();
+    if (flushPolicy ? flushPolicy->onMessage(pendingEvents)
+                    : alwaysSendImmediately_)
+        transmit();
+}
+
 template <class Backend>
 void GenericUSBMIDI_Interface<Backend>::sendChannelMessageImpl(
     ChannelMessage msg) {
     sender.sendChannelMessage(msg, Sender {this});
-    if (alwaysSendImmediately_)
-        backend.sendNow();
+    endMessage();
 }
 
 template <class Backend>
 void GenericUSBMIDI_Interface<Backend>::sendSysCommonImpl(
     SysCommonMessage msg) {
     sender.sendSysCommonMessage(msg, Sender {this});
-    if (alwaysSendImmediately_)
-        backend.sendNow();
+    endMessage();
 }
 
 template <class Backend>
 void GenericUSBMIDI_Interface<Backend>::sendSysExImpl(const SysExMessage msg) {
     sender.sendSysEx(msg, Sender {this});
-    if (alwaysSendImmediately_)
-        backend.sendNow();
+    endMessage();
 }
 
 template <class Backend>
 void GenericUSBMIDI_Interface<Backend>::sendRealTimeImpl(RealTimeMessage msg) {
-    sender.sendRealTimeMessage(msg, Sender {this});
-    if (alwaysSendImmediately_)
-        backend.sendNow();
+    // Real-time messages are never held back by a transaction, but they
+    // shouldn't release the packets the transaction is holding back either
+    sender.sendRealTimeMessage(msg, DirectSender {this});
+    if (flushPolicy || alwaysSendImmediately_)
+        transmit();
 }
 
 END_CS_NAMESPACE
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <MIDI_Parsers/MIDIStatusTable.hpp>
 #include <MIDI_Parsers/MIDI_MessageTypes.hpp>
 #include <Settings/SettingsWrapper.hpp>
 
@@ -80,19 +81,12 @@ void USBMIDI_Sender::sendChannelMessage(ChannelMessage msg, Send &&send) {
 
 template <class Send>
 void USBMIDI_Sender::sendSysCommonMessage(SysCommonMessage msg, Send &&send) {
-    auto cn = msg.cable;
-    switch (msg.getNumberOfDataBytes()) {
-        case 2: // 3B
-            send(cn, CIN::SystemCommon3B, msg.header, msg.data1, msg.data2);
-            break;
-        case 1: // 2B
-            send(cn, CIN::SystemCommon2B, msg.header, msg.data1, 0);
-            break;
-        case 0: // 1B
-            send(cn, CIN::SystemCommon1B, msg.header, 0, 0);
-            break;
-        default: break;
-    }
+    MIDIStatusInfo info = MIDIStatusInfo::lookup(msg.header);
+    uint8_t length = info.getDataLength();
+    send(msg.cable, info.getCIN(), // CN|CIN
+         msg.header,               // status
+         length >= 1 ? msg.data1 : 0,
+         length >= 2 ? msg.data2 : 0);
 }
 
 template <class Send>
@@ -28,7 +28,9 @@ class MIDIButtonInverse : public MIDIOutputElement {
      *          The MIDI sender to use.
      */
     MIDIButtonInverse(pin_t pin, MIDIAddress address, const Sender &sender)
-        : button(pin), address(address), sender(sender) {}
+        : button(pin), address(address), sender(sender) {
+        setUpdateRate(AH::UpdateRate::Fast);
+    }
 
     void begin() override { button.begin(); }
     void update() override {
@@ -29,7 +29,9 @@ class MIDIFilteredAnalog : public MIDIOutputElement {
      */
     MIDIFilteredAnalog(pin_t analogPin, MIDIAddress address,
                        const Sender &sender)
-        : filteredAnalog(analogPin), address(address), sender(sender) {}
+        : filteredAnalog(analogPin), address(address), sender(sender) {
+        setUpdatePeriod(AH::FILTERED_INPUT_UPDATE_INTERVAL);
+    }
 
   public:
     void begin() final override { filteredAnalog.resetToCurrentValue(); }
@@ -30,7 +30,10 @@ protected:
    */
   MIDIFilteredTouch(int touchPin, MIDIAddress address,
                     const Sender &sender)
-      : FilteredTouch(touchPin), address(address), sender(sender) {}
+      : FilteredTouch(touchPin), address(address), sender(sender)
+  {
+    setUpdateRate(AH::UpdateRate::Slow);
+  }
 
 public:
   void begin() final override
@@ -41,13 +44,21 @@ public:
 
   void update() final override
   {
+    // Only send when a new sample changed the value
     if (FilteredTouch.update())
-    {
-      int value = FilteredTouch.getValue();
-    
-    // Send the value to the MIDI sender
-    sender.send(value, address);
-    }
+      sender.send(FilteredTouch.getValue(), address);
+  }
+
+  /**
+   * @brief   Set the time between two samples of the touch sensor in
+   *          microseconds, and update the element at the same rate.
+   *
+   * @see     AH::FilteredTouch::setSamplePeriod
+   */
+  void setSamplePeriod(unsigned long period)
+  {
+    FilteredTouch.setSamplePeriod(period);
+    setUpdatePeriod(period);
   }
 
   /// Get the MIDI address.
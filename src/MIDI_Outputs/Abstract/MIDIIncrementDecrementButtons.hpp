@@ -26,7 +26,9 @@ class MIDIIncrementDecrementButtons : public MIDIOutputElement {
                                   const ResetSender &resetSender)
         : buttons(buttons), address(address), multiplier(multiplier),
           resetAddress(resetAddress), relativeSender(relativeSender),
-          resetSender(resetSender) {}
+          resetSender(resetSender) {
+        setUpdateRate(AH::UpdateRate::Fast);
+    }
 
   public:
     void begin() override { buttons.begin(); }
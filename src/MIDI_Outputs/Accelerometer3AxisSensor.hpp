@@ -40,7 +40,9 @@ public:
      * @param addressZ MIDI address for the Z-axis data.
      */
     Accelerometer3AxisSensor(MIDIAddress addressX, MIDIAddress addressY, MIDIAddress addressZ)
-        : CCAccelerometerSender(addressX, addressY, addressZ) {}
+        : CCAccelerometerSender(addressX, addressY, addressZ) {
+        setUpdateRate(AH::UpdateRate::Slow);
+    }
 
     /// Initializes the accelerometer sensor and sets up the necessary communication.
     void begin() {
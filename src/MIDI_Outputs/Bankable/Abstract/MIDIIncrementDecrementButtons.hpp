@@ -29,7 +29,9 @@ class MIDIIncrementDecrementButtons : public MIDIOutputElement {
                                   const RelativeSender &relativeSender,
                                   const ResetSender &resetSender)
         : addresses(addresses), buttons(buttons), multiplier(multiplier),
-          relativeSender(relativeSender), resetSender(resetSender) {}
+          relativeSender(relativeSender), resetSender(resetSender) {
+        setUpdateRate(AH::UpdateRate::Fast);
+    }
 
   public:
     void begin() override { buttons.begin(); }
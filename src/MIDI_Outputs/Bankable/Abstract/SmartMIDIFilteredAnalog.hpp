@@ -44,7 +44,9 @@ class SmartMIDIFilteredAnalog : public MIDIOutputElement {
      */
     SmartMIDIFilteredAnalog(BankAddress bankAddress, pin_t analogPin,
                             const Sender &sender)
-        : address(bankAddress), filteredAnalog(analogPin), sender(sender) {}
+        : address(bankAddress), filteredAnalog(analogPin), sender(sender) {
+        setUpdatePeriod(AH::FILTERED_INPUT_UPDATE_INTERVAL);
+    }
 
   public:
     /// State of the smart potentiometer.
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <MIDI_Outputs/Abstract/MIDIFilteredAnalog.hpp>
+#include <MIDI_Senders/ContinuousCCSender.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   A class of MIDIOutputElement%s that read the analog input from a
+ *          **potentiometer or fader**, and send out 32-bit MIDI 2.0
+ *          **Control Change** events.
+ * 
+ * Every change is sent as a single Universal MIDI Packet, use a MIDI 2.0
+ * interface such as @ref StreamUMP_Interface to receive the full resolution.
+ * The analog input is filtered and hysteresis is applied for maximum
+ * stability.  
+ * This version cannot be banked.
+ *
+ * @ingroup MIDIOutputElements
+ */
+class CCPotentiometer32 : public MIDIFilteredAnalog<ContinuousCCSender32<10>> {
+  public:
+    /** 
+     * @brief   Create a new CCPotentiometer32 object with the given analog pin, 
+     *          controller number and channel.
+     * 
+     * @param   analogPin
+     *          The analog input pin to read from.
+     * @param   address
+     *          The MIDI address containing the controller number [0, 119], 
+     *          channel [CHANNEL_1, CHANNEL_16], and optional cable number 
+     *          [CABLE_1, CABLE_16].
+     */
+    CCPotentiometer32(pin_t analogPin, MIDIAddress address)
+        : MIDIFilteredAnalog(analogPin, address, {}) {}
+};
+
+END_CS_NAMESPACE
@@ -0,0 +1,56 @@
+#include "ControlChange14Assembler.hpp"
+#include <MIDI_Constants/Control_Change.hpp>
+
+BEGIN_CS_NAMESPACE
+
+void ControlChange14Assembler::reset() {
+    for (auto &slot : slots)
+        slot.flags = 0;
+}
+
+bool ControlChange14Assembler::feed(ChannelMessage msg) {
+    if (msg.getMessageType() != MIDIMessageType::ControlChange)
+        return false;
+    uint8_t cc = msg.getData1(), val = msg.getData2();
+    if (cc >= 0x40 || (cc & 0x1F) == MIDI_CC::Data_Entry_MSB)
+        return false;
+    bool lsb = cc >= 0x20;
+    cc &= 0x1F;
+    uint8_t cable_channel = (msg.getCable().getRaw() << 4) |
+                            msg.getChannel().getRaw();
+
+    // Find the slot of this controller and move it to the front, so the least
+    // recently used slot is the last one
+    uint8_t i = 0;
+    while (i < CC14_INPUT_SLOTS - 1 &&
+           !((slots[i].flags & Used) && slots[i].cable_channel == cable_channel &&
+             slots[i].controller == cc))
+        ++i;
+    Slot slot = slots[i];
+    bool found = (slot.flags & Used) && slot.cable_channel == cable_channel &&
+                 slot.controller == cc;
+    if (!found) {
+        // Without the MSB, the LSB is meaningless
+        if (lsb)
+            return false;
+        slot = {cable_channel, cc, Used, 0};
+    }
+    for (; i > 0; --i)
+        slots[i] = slots[i - 1];
+
+    bool emit;
+    if (lsb) {
+        slot.value = (slot.value & 0x3F80) | val;
+        slot.flags |= Fine;
+        emit = true;
+    } else {
+        slot.value = uint16_t(val) << 7;
+        emit = !(slot.flags & Fine);
+    }
+    slots[0] = slot;
+    if (emit)
+        message = {{cc, msg.getChannel(), msg.getCable()}, slot.value};
+    return emit;
+}
+
+END_CS_NAMESPACE
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "MIDI_MessageTypes.hpp"
+#include <Def/MIDIAddress.hpp>
+#include <Settings/SettingsWrapper.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   A 14-bit Control Change value, assembled from the MSB (controllers
+ *          0-31) and LSB (controllers 32-63) messages.
+ *
+ * @ingroup MIDIParsers
+ */
+struct ControlChange14Message {
+    /// The address of the MSB controller, including channel and cable.
+    MIDIAddress address;
+    /// The 14-bit value.
+    uint16_t value;
+
+    /// Get the most significant 7 bits of the value.
+    uint8_t getValueMSB() const { return value >> 7; }
+};
+
+/**
+ * @brief   Combines the MSB and LSB Control Change messages of 14-bit
+ *          controllers into a single value.
+ *
+ * A controller that only ever receives MSB messages produces a message for
+ * every MSB. Once the LSB of a controller has been received, the MSB is
+ * considered the first half of a 14-bit value: it resets the LSB to zero, and
+ * the message is produced when the LSB arrives. An LSB on its own updates the
+ * fine value, using the last MSB.
+ *
+ * The Data Entry controller (6 and 38) is not handled, it's part of the RPN
+ * and NRPN messages, see @ref ParameterNumberAssembler.
+ *
+ * To save memory, only the @ref CC14_INPUT_SLOTS most recently used
+ * controllers are tracked. An LSB for a controller whose MSB is not known is
+ * ignored.
+ *
+ * @ingroup MIDIParsers
+ */
+class ControlChange14Assembler {
+  public:
+    /// Feed a new Channel Voice message to the assembler.
+    /// @return True if a 14-bit value is available, retrieve it using
+    ///         @ref getMessage().
+    bool feed(ChannelMessage msg);
+
+    /// Get the latest 14-bit value.
+    ControlChange14Message getMessage() const { return message; }
+
+    /// Forget the values of all controllers.
+    void reset();
+
+  private:
+    enum Flags : uint8_t {
+        Used = 1 << 0, ///< The slot is in use.
+        Fine = 1 << 1, ///< The sender uses the LSB of this controller.
+    };
+    struct Slot {
+        uint8_t cable_channel;
+        uint8_t controller;
+        uint8_t flags;
+        uint16_t value;
+    };
+
+    Slot slots[CC14_INPUT_SLOTS] = {};
+    ControlChange14Message message = {};
+};
+
+END_CS_NAMESPACE
@@ -0,0 +1,55 @@
+#include "MIDIStatusTable.hpp"
+
+BEGIN_CS_NAMESPACE
+
+using MSI = MIDIStatusInfo;
+
+static_assert(MSI::classify(0x7F).getClass() == MSI::Data, "");
+static_assert(MSI::classify(0x93).getDataLength() == 2, "");
+static_assert(MSI::classify(0xC5).getDataLength() == 1, "");
+static_assert(MSI::classify(0xD0).getDataLength() == 1, "");
+static_assert(MSI::classify(0xEF).getCIN() == MIDICodeIndexNumber::PitchBend,
+              "");
+static_assert(MSI::classify(0xB0).isRunningStatusEligible(), "");
+static_assert(!MSI::classify(0xF1).isRunningStatusEligible(), "");
+static_assert(MSI::classify(0xF2).getCIN() ==
+                  MIDICodeIndexNumber::SystemCommon3B,
+              "");
+static_assert(MSI::classify(0xF3).getCIN() ==
+                  MIDICodeIndexNumber::SystemCommon2B,
+              "");
+static_assert(MSI::classify(0xF6).getCIN() ==
+                  MIDICodeIndexNumber::SystemCommon1B,
+              "");
+static_assert(MSI::classify(0xF7).getClass() == MSI::SysExEnd, "");
+static_assert(MSI::classify(0xF8).getClass() == MSI::RealTime, "");
+
+#ifdef __AVR__
+#define CS_MIDI_STATUS_TABLE_ATTR PROGMEM
+#else
+#define CS_MIDI_STATUS_TABLE_ATTR
+#endif
+
+#define CS_MIDI_STATUS_4(b)                                                    \
+    MSI::classify(b).bits, MSI::classify(b + 1).bits,                          \
+        MSI::classify(b + 2).bits, MSI::classify(b + 3).bits
+#define CS_MIDI_STATUS_16(b)                                                   \
+    CS_MIDI_STATUS_4(b), CS_MIDI_STATUS_4(b + 4), CS_MIDI_STATUS_4(b + 8),     \
+        CS_MIDI_STATUS_4(b + 12)
+#define CS_MIDI_STATUS_64(b)                                                   \
+    CS_MIDI_STATUS_16(b), CS_MIDI_STATUS_16(b + 16),                           \
+        CS_MIDI_STATUS_16(b + 32), CS_MIDI_STATUS_16(b + 48)
+
+const uint16_t MIDIStatusTable[256] CS_MIDI_STATUS_TABLE_ATTR = {
+    CS_MIDI_STATUS_64(0x00),
+    CS_MIDI_STATUS_64(0x40),
+    CS_MIDI_STATUS_64(0x80),
+    CS_MIDI_STATUS_64(0xC0),
+};
+
+#undef CS_MIDI_STATUS_64
+#undef CS_MIDI_STATUS_16
+#undef CS_MIDI_STATUS_4
+#undef CS_MIDI_STATUS_TABLE_ATTR
+
+END_CS_NAMESPACE
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "MIDI_MessageTypes.hpp"
+#include <Settings/NamespaceSettings.hpp>
+
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#endif
+
+BEGIN_CS_NAMESPACE
+
+/// The properties of all 256 possible MIDI bytes, indexed by the byte.
+/// Stored in flash on AVR, use @ref MIDIStatusInfo::lookup to read it.
+/// @see    MIDIStatusInfo
+extern const uint16_t MIDIStatusTable[256];
+
+/**
+ * @brief   Classification of a MIDI status byte: the type of message it starts,
+ *          the number of data bytes, the MIDI USB Code Index Number, and
+ *          whether it can be used for running status.
+ *
+ * The properties of all bytes are computed at compile time by @ref classify
+ * and stored in @ref MIDIStatusTable, so the parsers can classify a byte
+ * using a single table lookup instead of a series of comparisons.
+ *
+ * @ingroup MIDIParsers
+ */
+struct MIDIStatusInfo {
+    /// The type of message started by a byte.
+    enum Class : uint8_t {
+        Data = 0,       ///< Not a status byte.
+        Channel = 1,    ///< Channel Voice message.
+        SysExStart = 2, ///< Start of System Exclusive.
+        SysCommon = 3,  ///< System Common message (except SysEx End).
+        SysExEnd = 4,   ///< End of System Exclusive.
+        RealTime = 5,   ///< System Real-Time message.
+    };
+
+    /// The encoded properties: bits 0-1 hold the number of data bytes, bits
+    /// 2-4 the class, bit 5 whether the status can be used for running
+    /// status, and bits 8-11 the USB Code Index Number.
+    uint16_t bits;
+
+    /// Get the type of message.
+    constexpr Class getClass() const { return Class((bits >> 2) & 0x07); }
+    /// Get the number of data bytes of the message (0, 1 or 2).
+    constexpr uint8_t getDataLength() const { return bits & 0x03; }
+    /// Get the MIDI USB Code Index Number of a complete message with this
+    /// status.
+    constexpr MIDICodeIndexNumber getCIN() const {
+        return MIDICodeIndexNumber((bits >> 8) & 0x0F);
+    }
+    /// Check whether the status byte becomes the running status after the
+    /// message is complete (i.e. whether it's a Channel Voice message).
+    constexpr bool isRunningStatusEligible() const { return bits & (1 << 5); }
+
+    /// Compute the properties of the given byte. Used to fill the table.
+    constexpr static MIDIStatusInfo classify(uint8_t status);
+
+    /// Look up the properties of the given byte in @ref MIDIStatusTable.
+    static MIDIStatusInfo lookup(uint8_t status) {
+#ifdef __AVR__
+        return {uint16_t(pgm_read_word(&MIDIStatusTable[status]))};
+#else
+        return {MIDIStatusTable[status]};
+#endif
+    }
+
+  private:
+    constexpr static MIDIStatusInfo encode(Class cls, uint8_t length,
+                                           uint8_t cin, bool running) {
+        return {uint16_t(length | (cls << 2) | (running ? 1 << 5 : 0) |
+                         (cin << 8))};
+    }
+};
+
+constexpr MIDIStatusInfo MIDIStatusInfo::classify(uint8_t s) {
+    // clang-format off
+    return s < 0x80 ? encode(Data, 0, 0x0, false)
+         // Program Change and Channel Pressure have a single data byte
+         : s < 0xF0 ? encode(Channel, (s & 0xE0) == 0xC0 ? 1 : 2, s >> 4, true)
+         : s == 0xF0 ? encode(SysExStart, 0, 0x4, false)
+         : s == 0xF2 ? encode(SysCommon, 2, 0x3, false)
+         : s == 0xF1 || s == 0xF3 ? encode(SysCommon, 1, 0x2, false)
+         : s == 0xF7 ? encode(SysExEnd, 0, 0x5, false)
+         : s < 0xF8 ? encode(SysCommon, 0, 0x5, false)
+         : encode(RealTime, 0, 0xF, false);
+    // clang-format on
+}
+
+END_CS_NAMESPACE
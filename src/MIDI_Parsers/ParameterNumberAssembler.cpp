@@ -0,0 +1,94 @@
+#include "ParameterNumberAssembler.hpp"
+#include <MIDI_Constants/Control_Change.hpp>
+
+BEGIN_CS_NAMESPACE
+
+bool ParameterNumberAssembler::isParameterNumberController(uint8_t cc) {
+    return cc == MIDI_CC::Data_Entry_MSB || cc == MIDI_CC::Data_Entry_MSB_LSB ||
+           (cc >= MIDI_CC::Data_Increment && cc <= MIDI_CC::RPN_MSB);
+}
+
+void ParameterNumberAssembler::reset() {
+    for (auto &slot : slots)
+        slot.flags = 0;
+}
+
+auto ParameterNumberAssembler::lookup(uint8_t key) -> Slot & {
+    uint8_t i = 0;
+    while (i < NRPN_INPUT_SLOTS - 1 &&
+           !((slots[i].flags & Used) && slots[i].key == key))
+        ++i;
+    Slot slot = slots[i];
+    if (!(slot.flags & Used) || slot.key != key)
+        slot = {key, Used, 0, 0};
+    // Move to the front, so the least recently used slot is the last one
+    for (; i > 0; --i)
+        slots[i] = slots[i - 1];
+    slots[0] = slot;
+    return slots[0];
+}
+
+bool ParameterNumberAssembler::emit(const Slot &slot,
+                                    MIDIChannelCable address) {
+    if (!(slot.flags & Selected))
+        return false;
+    message = {address, slot.number, slot.value,
+               bool(slot.flags & Registered)};
+    return true;
+}
+
+bool ParameterNumberAssembler::feed(ChannelMessage msg) {
+    if (msg.getMessageType() != MIDIMessageType::ControlChange)
+        return false;
+    uint8_t cc = msg.getData1(), val = msg.getData2();
+    if (!isParameterNumberController(cc))
+        return false;
+    MIDIChannelCable address {msg.getChannel(), msg.getCable()};
+    Slot &slot = lookup((address.getRawCableNumber() << 4) |
+                        address.getRawChannel());
+
+    // Parameter number selection
+    if (cc >= MIDI_CC::NRPN_LSB) {
+        if (cc == MIDI_CC::NRPN_MSB || cc == MIDI_CC::RPN_MSB)
+            slot.number = (slot.number & 0x007F) | (uint16_t(val) << 7);
+        else
+            slot.number = (slot.number & 0x3F80) | val;
+        uint8_t registered = cc >= MIDI_CC::RPN_LSB ? Registered : 0;
+        // The RPN Null Function deselects the parameter
+        bool null = registered && slot.number == 0x3FFF;
+        slot.flags = (slot.flags & ~(Selected | Registered | Known)) |
+                     registered | (null ? 0 : Selected);
+        slot.value = 0;
+        return false;
+    }
+
+    // Data entry
+    switch (cc) {
+        case MIDI_CC::Data_Entry_MSB:
+            // Per the MIDI spec, a new MSB resets the LSB
+            slot.value = uint16_t(val) << 7;
+            slot.flags |= Known;
+            return !(slot.flags & Fine) && emit(slot, address);
+        case MIDI_CC::Data_Entry_MSB_LSB:
+            slot.value = (slot.value & 0x3F80) | val;
+            slot.flags |= Fine;
+            return (slot.flags & Known) && emit(slot, address);
+        // Increments and decrements are relative to the current value, which
+        // we can't know before a Data Entry MSB was received
+        case MIDI_CC::Data_Increment:
+            if (!(slot.flags & Known))
+                return false;
+            if (slot.value < 0x3FFF)
+                ++slot.value;
+            return emit(slot, address);
+        case MIDI_CC::Data_Decrement:
+            if (!(slot.flags & Known))
+                return false;
+            if (slot.value > 0)
+                --slot.value;
+            return emit(slot, address);
+        default: return false; // LCOV_EXCL_LINE
+    }
+}
+
+END_CS_NAMESPACE
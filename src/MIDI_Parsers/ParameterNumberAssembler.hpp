@@ -0,0 +1,101 @@
+#pragma once
+
+#include "MIDI_MessageTypes.hpp"
+#include <Def/MIDIAddress.hpp>
+#include <Settings/SettingsWrapper.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   A Registered or Non-Registered Parameter Number message, i.e. a
+ *          14-bit value for a 14-bit parameter number, assembled from a
+ *          sequence of Control Change messages.
+ *
+ * @ingroup MIDIParsers
+ */
+struct ParameterNumberMessage {
+    /// The channel and cable the parameter was received on.
+    MIDIChannelCable address;
+    /// The 14-bit parameter number.
+    uint16_t number;
+    /// The 14-bit value.
+    uint16_t value;
+    /// True for a Registered Parameter Number (RPN), false for a
+    /// Non-Registered Parameter Number (NRPN).
+    bool registered;
+
+    /// Get the most significant 7 bits of the value (i.e. the value of a
+    /// 7-bit parameter).
+    uint8_t getValueMSB() const { return value >> 7; }
+};
+
+/**
+ * @brief   Assembles RPN and NRPN messages from the Control Change messages
+ *          that carry them.
+ *
+ * The parameter number is selected using the (N)RPN MSB and LSB controllers,
+ * and its value is set using the Data Entry MSB and LSB controllers, or
+ * adjusted by one using Data Increment and Data Decrement. This class keeps
+ * track of the selected parameter and its value for each cable and channel,
+ * and produces a single @ref ParameterNumberMessage for every change of the
+ * value.
+ *
+ * Senders that only send the Data Entry MSB (7-bit values) produce a message
+ * for every MSB. Once a Data Entry LSB has been received on a channel, the
+ * MSB is considered the first half of a 14-bit value, and the message is
+ * produced when the LSB arrives.
+ *
+ * Data Increment and Data Decrement (and a Data Entry LSB without an MSB)
+ * are relative to a value that the receiver should already know. They are
+ * ignored until a Data Entry MSB has been received for the selected
+ * parameter, instead of producing an absolute value computed from an unknown
+ * base.
+ *
+ * To save memory, only the @ref NRPN_INPUT_SLOTS most recently used
+ * channels are tracked.
+ *
+ * @ingroup MIDIParsers
+ */
+class ParameterNumberAssembler {
+  public:
+    /// Feed a new Channel Voice message to the assembler.
+    /// @return True if a parameter message is available, retrieve it using
+    ///         @ref getMessage().
+    bool feed(ChannelMessage msg);
+
+    /// Get the latest parameter message.
+    ParameterNumberMessage getMessage() const { return message; }
+
+    /// Forget the selected parameters and values of all channels.
+    void reset();
+
+    /// Check whether the given Control Change controller number is used to
+    /// transmit RPN or NRPN messages.
+    static bool isParameterNumberController(uint8_t controller);
+
+  private:
+    enum Flags : uint8_t {
+        Used = 1 << 0,       ///< The slot is in use.
+        Selected = 1 << 1,   ///< A parameter number is selected.
+        Registered = 1 << 2, ///< The selected parameter is an RPN.
+        Fine = 1 << 3,       ///< The sender uses the Data Entry LSB.
+        Known = 1 << 4,      ///< The value of the parameter was received.
+    };
+    struct Slot {
+        uint8_t key;
+        uint8_t flags;
+        uint16_t number;
+        uint16_t value;
+    };
+
+    /// Find the slot for the given cable and channel, or take the least
+    /// recently used one. The slot is moved to the front.
+    Slot &lookup(uint8_t key);
+    /// Store the message for the value in the given slot.
+    bool emit(const Slot &slot, MIDIChannelCable address);
+
+    Slot slots[NRPN_INPUT_SLOTS] = {};
+    ParameterNumberMessage message = {};
+};
+
+END_CS_NAMESPACE
@@ -1,4 +1,5 @@
 #include "SerialMIDI_Parser.hpp"
+#include "MIDIStatusTable.hpp"
 
 BEGIN_CS_NAMESPACE
 
@@ -12,6 +13,11 @@ MIDIReadEvent SerialMIDI_Parser::handleNonRealTimeStatus(uint8_t midiByte) {
     // If a SysEx message was being received, and now we receive another
     // status byte, the status byte should terminate the SysEx message
     // first, and then we can handle the new status byte later.
+    // If the memory of the message was reclaimed because it stalled, the
+    // message was dropped already
+    if (currentHeader == uint8_t(MIDIMessageType::SysExStart) &&
+        !receivingSysEx())
+        currentHeader = 0;
     bool untermSysEx = currentHeader == uint8_t(MIDIMessageType::SysExStart);
     if (untermSysEx) {
         // Handle this new status byte later (unless it's just a SysEx End
@@ -44,6 +50,7 @@ MIDIReadEvent SerialMIDI_Parser::handleNonRealTimeStatus(uint8_t midiByte) {
             if (sysCommonCancelsRunningStatus)
                 runningHeader = 0;
             currentHeader = 0;
+            thirdByte = false;
             return MIDIReadEvent::SYSCOMMON_MESSAGE;
         }
 #if !IGNORE_SYSEX
@@ -51,8 +58,15 @@ MIDIReadEvent SerialMIDI_Parser::handleNonRealTimeStatus(uint8_t midiByte) {
         // and store the start byte.
         else if (midiByte == uint8_t(MIDIMessageType::SysExStart)) {
             startSysEx();
-            addSysExByte(uint8_t(MIDIMessageType::SysExStart));
             runningHeader = 0;
+            // An unfinished message before the SysEx start is discarded.
+            thirdByte = false;
+            // If there's no memory for the message, ignore it.
+            if (!receivingSysEx()) {
+                currentHeader = 0;
+                return MIDIReadEvent::NO_MESSAGE;
+            }
+            addSysExByte(uint8_t(MIDIMessageType::SysExStart));
             currentHeader = midiByte;
             return MIDIReadEvent::NO_MESSAGE;
         }
@@ -84,7 +98,8 @@ MIDIReadEvent SerialMIDI_Parser::handleNonRealTimeStatus(uint8_t midiByte) {
 
 MIDIReadEvent SerialMIDI_Parser::handleStatus(uint8_t midiByte) {
     // If it's a Real-Time message
-    if (midiByte >= uint8_t(MIDIMessageType::TimingClock)) {
+    if (MIDIStatusInfo::lookup(midiByte).getClass() ==
+        MIDIStatusInfo::RealTime) {
         return handleRealTime(midiByte);
     }
     // Normal header (channel message, system exclusive, system common):
@@ -105,80 +120,53 @@ MIDIReadEvent SerialMIDI_Parser::handleData(uint8_t midiByte) {
     }
 
     midimsg.header = currentHeader;
+    MIDIStatusInfo info = MIDIStatusInfo::lookup(currentHeader);
+    bool channel = info.getClass() == MIDIStatusInfo::Channel;
 
-    // If this is the third byte of three (second data byte)
-    if (thirdByte) {
-        // If it's a channel message
-        if (midimsg.hasValidChannelMessageHeader()) {
+    // If it's a channel or system common message with data bytes
+    if (channel || (info.getClass() == MIDIStatusInfo::SysCommon &&
+                    info.getDataLength() > 0)) {
+        // If this is the third byte of three (second data byte)
+        if (thirdByte) {
             midimsg.data2 = midiByte;
             // Next byte is either a header or the first data byte of the next
             // message, so clear the thirdByte flag
             thirdByte = false;
-            runningHeader = midimsg.header;
-            currentHeader = 0;
-            return MIDIReadEvent::CHANNEL_MESSAGE;
-        }
-        // If it's a system common message
-        else if (midimsg.hasValidSystemCommonHeader()) {
-            midimsg.data2 = midiByte;
-            thirdByte = false;
-            if (sysCommonCancelsRunningStatus)
-                runningHeader = 0;
-            currentHeader = 0;
-            return MIDIReadEvent::SYSCOMMON_MESSAGE;
         }
-    }
-
-    // If this is not the third byte of three, it's either the second byte
-    // (first data byte) of a channel or system common message,
-    // or a SysEx data byte
-
-    // If it's a channel message
-    else if (midimsg.hasValidChannelMessageHeader()) {
-        // If it's a channel message with two data bytes
-        if (ChannelMessage(midimsg).hasTwoDataBytes()) {
+        // If it's the first of two data bytes
+        else if (info.getDataLength() == 2) {
             midimsg.data1 = midiByte;
             // We've received the second byte, expect the third byte next
             thirdByte = true;
             return MIDIReadEvent::NO_MESSAGE;
         }
-        // If it's a channel message with one data byte
+        // If it's the only data byte
         else {
             midimsg.data1 = midiByte;
             midimsg.data2 = 0;
+        }
+        // The message is finished
+        currentHeader = 0;
+        if (channel) {
             runningHeader = midimsg.header;
-            currentHeader = 0;
-            // The message is finished
             return MIDIReadEvent::CHANNEL_MESSAGE;
         }
-    }
-
-    // If it's a system common message
-    else if (midimsg.hasValidSystemCommonHeader()) {
-        // If it's a system common message with two data bytes
-        if (SysCommonMessage(midimsg).getNumberOfDataBytes() == 2) {
-            midimsg.data1 = midiByte;
-            // We've received the second byte, expect the third byte next
-            thirdByte = true;
-            return MIDIReadEvent::NO_MESSAGE;
-        }
-        // If it's a system common message with one data byte
-        else if (SysCommonMessage(midimsg).getNumberOfDataBytes() == 1) {
-            midimsg.data1 = midiByte;
-            midimsg.data2 = 0;
-            if (sysCommonCancelsRunningStatus)
-                runningHeader = 0;
-            currentHeader = 0;
-            // The message is finished
-            return MIDIReadEvent::SYSCOMMON_MESSAGE;
-        }
+        if (sysCommonCancelsRunningStatus)
+            runningHeader = 0;
+        return MIDIReadEvent::SYSCOMMON_MESSAGE;
     }
 
     // Otherwise, it's not a channel message
 
 #if !IGNORE_SYSEX
     // If we're receiving a SysEx message, it's a SysEx data byte
-    else if (currentHeader == uint8_t(MIDIMessageType::SysExStart)) {
+    else if (info.getClass() == MIDIStatusInfo::SysExStart) {
+        // The memory may have been reclaimed because the message stalled, or
+        // there was no memory left for the next chunk: drop the message
+        if (!receivingSysEx()) {
+            currentHeader = 0;
+            return MIDIReadEvent::NO_MESSAGE;
+        }
         // Check if the SysEx buffer has enough space to store the data
         if (!hasSysExSpace()) {
             storeByte(midiByte); // Remember to add it next time
@@ -199,13 +187,13 @@ MIDIReadEvent SerialMIDI_Parser::handleData(uint8_t midiByte) {
 MIDIReadEvent SerialMIDI_Parser::feed(uint8_t midiByte) {
     // DEBUGREF(hex << NAMEDVALUE(midiByte) << dec);
 
-    // If it's a status byte (first byte of a message)
-    if (isStatus(midiByte)) {
-        return handleStatus(midiByte);
-    }
-    // If it's a data byte
-    else {
-        return handleData(midiByte);
+    switch (MIDIStatusInfo::lookup(midiByte).getClass()) {
+        // If it's a data byte
+        case MIDIStatusInfo::Data: return handleData(midiByte);
+        // If it's a Real-Time message
+        case MIDIStatusInfo::RealTime: return handleRealTime(midiByte);
+        // Normal header (channel message, system exclusive, system common)
+        default: return handleNonRealTimeStatus(midiByte);
     }
 }
 
@@ -226,4 +214,117 @@ MIDIReadEvent SerialMIDI_Parser::resume() {
     return feed(midiByte);
 }
 
+bool SerialMIDI_Parser::addToBatch(Batch &batch, MIDIReadEvent evt) const {
+    if (evt == MIDIReadEvent::REALTIME_MESSAGE)
+        return batch.add(evt, rtmsg.message, 0, 0);
+    return batch.add(evt, midimsg.header, midimsg.data1, midimsg.data2);
+}
+
+SerialMIDI_Parser::Batch SerialMIDI_Parser::parse(const uint8_t *begin,
+                                                  const uint8_t *end) {
+    Batch batch;
+    batch.next = begin;
+    // A byte that was stored by the previous call has to be parsed first.
+    MIDIReadEvent evt = resume();
+    if (evt != MIDIReadEvent::NO_MESSAGE && addToBatch(batch, evt))
+        return batch;
+
+    // Work on local copies of the state, so the compiler can keep them in
+    // registers instead of storing them after every byte.
+    uint8_t current = currentHeader;
+    uint8_t running = runningHeader;
+    bool third = thirdByte;
+    uint8_t header = midimsg.header;
+    uint8_t data1 = midimsg.data1;
+    uint8_t data2 = midimsg.data2;
+
+    auto save = [&] {
+        currentHeader = current;
+        runningHeader = running;
+        thirdByte = third;
+        midimsg.header = header;
+        midimsg.data1 = data1;
+        midimsg.data2 = data2;
+    };
+    auto load = [&] {
+        current = currentHeader;
+        running = runningHeader;
+        third = thirdByte;
+        header = midimsg.header;
+        data1 = midimsg.data1;
+        data2 = midimsg.data2;
+    };
+
+    const uint8_t *p = begin;
+    while (p != end) {
+        uint8_t midiByte = *p;
+        if (isData(midiByte)) {
+            // Fast path for the data bytes of Channel Voice messages, with or
+            // without running status.
+            uint8_t h = current != 0 ? current : running;
+            MIDIStatusInfo info = MIDIStatusInfo::lookup(h);
+            if (info.isRunningStatusEligible()) {
+                ++p;
+                header = h;
+                if (third) {
+                    data2 = midiByte;
+                    third = false;
+                } else if (info.getDataLength() == 2) {
+                    data1 = midiByte;
+                    third = true;
+                    current = h;
+                    continue;
+                } else {
+                    data1 = midiByte;
+                    data2 = 0;
+                }
+                running = h;
+                current = 0;
+                if (batch.add(MIDIReadEvent::CHANNEL_MESSAGE, h, data1, data2))
+                    break;
+                continue;
+            }
+#if !IGNORE_SYSEX
+            // Fast path for SysEx data: copy all data bytes that fit in the
+            // buffer at once.
+            if (current == uint8_t(MIDIMessageType::SysExStart)) {
+                uint16_t space = sysexbuffer.getSpaceLeft();
+                if (space > 0xFF)
+                    space = 0xFF;
+                const uint8_t *q = p;
+                const uint8_t *last = end - p > space ? p + space : end;
+                while (q != last && isData(*q))
+                    ++q;
+                if (q != p) {
+                    sysexbuffer.add(p, q - p);
+                    p = q;
+                    continue;
+                }
+                // If the buffer is full, the slow path below grows it, or
+                // returns a chunk.
+            }
+#endif
+        } else if (MIDIStatusInfo::lookup(midiByte).getClass() ==
+                   MIDIStatusInfo::RealTime) {
+            // Real-Time messages don't affect the state of the parser.
+            ++p;
+            rtmsg.message = midiByte;
+            if (batch.add(MIDIReadEvent::REALTIME_MESSAGE, midiByte, 0, 0))
+                break;
+            continue;
+        }
+        // Other status bytes, System Common and the start and end of SysEx
+        // messages are rare, so leave them to the byte-wise parser.
+        ++p;
+        save();
+        evt = feed(midiByte);
+        load();
+        if (evt != MIDIReadEvent::NO_MESSAGE && addToBatch(batch, evt))
+            break;
+    }
+    save();
+    batch.next = p;
+    return batch;
+}
+
 END_CS_NAMESPACE
\ No newline at end of file
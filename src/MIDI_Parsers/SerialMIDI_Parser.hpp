@@ -26,6 +26,66 @@ class SerialMIDI_Parser : public MIDI_Parser {
     template <class BytePuller>
     MIDIReadEvent pull(BytePuller &&puller);
 
+    /// A message returned by @ref parse(const uint8_t *, const uint8_t *).
+    struct Message {
+        /// The type of message.
+        MIDIReadEvent event;
+        /// The status byte, or the Real-Time message.
+        uint8_t header;
+        uint8_t data1;
+        uint8_t data2;
+
+        ChannelMessage getChannelMessage() const {
+            return ChannelMessage(MIDIMessage(header, data1, data2));
+        }
+        SysCommonMessage getSysCommonMessage() const {
+            return SysCommonMessage(MIDIMessage(header, data1, data2));
+        }
+        RealTimeMessage getRealTimeMessage() const { return {header}; }
+    };
+
+    /// The messages returned by @ref parse(const uint8_t *, const uint8_t *).
+    struct Batch {
+        Message messages[SERIAL_MIDI_PARSE_BATCH_SIZE];
+        /// The number of messages.
+        uint8_t count = 0;
+        /// The first byte that wasn't parsed yet.
+        const uint8_t *next;
+
+        const Message *begin() const { return messages; }
+        const Message *end() const { return messages + count; }
+
+      private:
+        /// Add a message, returns true if the batch is complete.
+        bool add(MIDIReadEvent event, uint8_t header, uint8_t data1,
+                 uint8_t data2) {
+            messages[count++] = {event, header, data1, data2};
+            return count == SERIAL_MIDI_PARSE_BATCH_SIZE ||
+                   event == MIDIReadEvent::SYSEX_MESSAGE ||
+                   event == MIDIReadEvent::SYSEX_CHUNK;
+        }
+        friend class SerialMIDI_Parser;
+    };
+
+    /**
+     * @brief   Parse a buffer of incoming MIDI bytes.
+     *
+     * Equivalent to calling @ref pull with a @ref BufferPuller until it runs
+     * out of bytes, but much faster, because the parser doesn't have to
+     * return after every message.
+     *
+     * Parsing stops after @ref SERIAL_MIDI_PARSE_BATCH_SIZE messages, or
+     * after a SysEx message or chunk, whichever comes first. The SysEx data
+     * is available using @ref getSysExMessage until the next call. Continue
+     * by calling `parse(batch.next, end)` until all bytes have been parsed.
+     *
+     * @param   begin
+     *          Pointer to the first byte to parse.
+     * @param   end
+     *          Pointer past the last byte to parse.
+     */
+    Batch parse(const uint8_t *begin, const uint8_t *end);
+
   protected:
     /// Feed a new byte to the parser.
     MIDIReadEvent feed(uint8_t midibyte);
@@ -41,8 +101,9 @@ class SerialMIDI_Parser : public MIDI_Parser {
 
   protected:
     void addSysExByte(uint8_t data) { sysexbuffer.add(data); }
-    bool hasSysExSpace() const { return sysexbuffer.hasSpaceLeft(); }
+    bool hasSysExSpace() { return sysexbuffer.reserve(); }
     void startSysEx() { sysexbuffer.start(); }
+    bool receivingSysEx() const { return sysexbuffer.isReceiving(); }
     void endSysEx() { sysexbuffer.end(); }
 
     SysExBuffer sysexbuffer;
@@ -53,6 +114,9 @@ class SerialMIDI_Parser : public MIDI_Parser {
     MIDIReadEvent handleNonRealTimeStatus(uint8_t midiByte);
     MIDIReadEvent handleStatus(uint8_t midiByte);
     MIDIReadEvent handleData(uint8_t midiByte);
+    /// Add the message that was just parsed to the batch.
+    /// @return True if the batch is complete.
+    bool addToBatch(Batch &batch, MIDIReadEvent evt) const;
 
   protected:
     /// Store a byte to parse later. This is used when the SysEx buffer is full,
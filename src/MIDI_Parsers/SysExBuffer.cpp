@@ -1,14 +1,36 @@
 #include "SysExBuffer.hpp"
+#include <AH/Arduino-Wrapper.h> // millis
 #include <string.h>
 
 BEGIN_CS_NAMESPACE
 
+SysExBuffer::~SysExBuffer() {
+    if (receiving)
+        SysExBufferPool::getDefault().release(buffer);
+}
+
 void SysExBuffer::start() {
     length = 0; // if the previous message wasn't finished, overwrite it
-    receiving = true;
+    lastActivity = millis();
+    if (receiving)
+        return; // keep the memory of the unfinished message
+    buffer = SysExBufferPool::getDefault().lease(SYSEX_BUFFER_SIZE, this);
+    capacity = buffer ? SYSEX_BUFFER_SIZE : 0;
+    receiving = buffer != nullptr;
+}
+
+void SysExBuffer::end() {
+    // The data stays intact until the pool leases the memory again
+    if (receiving)
+        SysExBufferPool::getDefault().release(buffer);
+    capacity = 0;
+    receiving = false;
 }
 
-void SysExBuffer::end() { receiving = false; }
+void SysExBuffer::abandon() {
+    end();
+    length = 0;
+}
 
 void SysExBuffer::add(uint8_t data) {
     buffer[length] = data;
@@ -18,19 +40,43 @@ void SysExBuffer::add(uint8_t data) {
 void SysExBuffer::add(const uint8_t *data, uint8_t len) {
     memcpy(buffer + length, data, len);
     length += len;
+    lastActivity = millis();
 }
 
 bool SysExBuffer::hasSpaceLeft(uint8_t amount) const {
-    bool avail = length <= SYSEX_BUFFER_SIZE - amount;
+    bool avail = length + amount <= capacity;
     if (!avail)
         DEBUG(F("SysEx: Buffer full (") << amount << ')');
     return avail;
 }
 
+bool SysExBuffer::reserve(uint8_t amount) {
+    lastActivity = millis();
+    if (length + amount <= capacity)
+        return true;
+    if (!receiving)
+        return false;
+    auto &pool = SysExBufferPool::getDefault();
+    // Grow in steps of SYSEX_BUFFER_SIZE, or just enough if that fails
+    uint32_t size = uint32_t(capacity) + SYSEX_BUFFER_SIZE;
+    uint8_t *grown = size <= pool.getSize() ? pool.resize(buffer, size) : nullptr;
+    if (grown == nullptr) {
+        size = length + amount;
+        grown = pool.resize(buffer, size);
+    }
+    if (grown == nullptr) {
+        DEBUG(F("SysEx: Buffer full (") << amount << ')');
+        return false;
+    }
+    buffer = grown;
+    capacity = size;
+    return true;
+}
+
 bool SysExBuffer::isReceiving() const { return receiving; }
 
 const uint8_t *SysExBuffer::getBuffer() const { return buffer; }
 
 uint16_t SysExBuffer::getLength() const { return length; }
 
-END_CS_NAMESPACE
\ No newline at end of file
+END_CS_NAMESPACE
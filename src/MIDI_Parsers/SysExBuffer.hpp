@@ -1,5 +1,6 @@
 #pragma once
 
+#include "SysExBufferPool.hpp"
 #include <Settings/SettingsWrapper.hpp>
 
 BEGIN_CS_NAMESPACE
@@ -7,17 +8,34 @@ BEGIN_CS_NAMESPACE
 /**
  * @brief   Helper for storing the System Exclusive messages being received by
  *          a MIDI parser.
+ *
+ * The memory is leased from the shared @ref SysExBufferPool when a message
+ * starts, and it's returned when the message ends. The data of a finished
+ * message can be read until the next message is started by any parser, i.e.
+ * until the next MIDI message is read.
+ *
+ * If no data is added to an unfinished message for @ref SYSEX_CHUNK_TIMEOUT
+ * milliseconds, the pool may reclaim its memory for other messages when it
+ * runs out. The rest of the stale message is then ignored.
  * 
  * @ingroup MIDIParsers
  */
 class SysExBuffer {
   private:
-    uint8_t buffer[SYSEX_BUFFER_SIZE];
+    uint8_t *buffer = nullptr;
+    uint16_t capacity = 0;
     uint16_t length = 0;
     bool receiving = false;
+    unsigned long lastActivity = 0;
 
   public:
-    /// Start a new SysEx message.
+    SysExBuffer() = default;
+    SysExBuffer(const SysExBuffer &) = delete;
+    SysExBuffer &operator=(const SysExBuffer &) = delete;
+    ~SysExBuffer();
+
+    /// Start a new SysEx message. If no memory is available, the message is
+    /// ignored, and @ref isReceiving returns false.
     void start();
     /// Finish the current SysEx message.
     void end();
@@ -27,12 +45,26 @@ class SysExBuffer {
     void add(const uint8_t *data, uint8_t len);
     /// Check if the buffer has at least `amount` bytes of free space available.
     bool hasSpaceLeft(uint8_t amount = 1) const;
+    /// Make sure that at least `amount` bytes of free space are available,
+    /// growing the buffer if necessary.
+    /// @return False if the pool doesn't have enough space left.
+    bool reserve(uint8_t amount = 1);
     /// Check if the buffer is receiving a SysEx message.
     bool isReceiving() const;
     /// Get a pointer to the buffer.
     const uint8_t *getBuffer() const;
     /// Get the length of the SysEx message in the buffer.
     uint16_t getLength() const;
+    /// Get the number of bytes that can be added without growing the buffer.
+    uint16_t getSpaceLeft() const { return capacity - length; }
+
+    /// Check whether this buffer is receiving a message, but hasn't received
+    /// any data for more than @ref SYSEX_CHUNK_TIMEOUT milliseconds.
+    bool isStale(unsigned long now) const {
+        return receiving && now - lastActivity > SYSEX_CHUNK_TIMEOUT;
+    }
+    /// Stop receiving the current message and return the memory to the pool.
+    void abandon();
 };
 
-END_CS_NAMESPACE
\ No newline at end of file
+END_CS_NAMESPACE
@@ -0,0 +1,135 @@
+#include "SysExBufferPool.hpp"
+#include "SysExBuffer.hpp"
+#include <AH/Arduino-Wrapper.h> // millis
+#include <string.h>
+
+BEGIN_CS_NAMESPACE
+
+SysExBufferPool SysExBufferPool::defaultPool;
+
+uint8_t SysExBufferPool::find(const uint8_t *block) const {
+    uint16_t offset = block - arena;
+    uint8_t i = 0;
+    while (i < numBlocks && blocks[i].offset != offset)
+        ++i;
+    return i;
+}
+
+uint8_t SysExBufferPool::findGap(uint16_t size, uint16_t &offset) const {
+    if (numBlocks == SYSEX_BUFFER_POOL_BLOCKS)
+        return SYSEX_BUFFER_POOL_BLOCKS;
+    uint16_t start = 0;
+    for (uint8_t i = 0; i <= numBlocks; ++i) {
+        uint16_t end = i < numBlocks ? blocks[i].offset : SYSEX_BUFFER_POOL_SIZE;
+        if (end - start >= size) {
+            offset = start;
+            return i;
+        }
+        if (i < numBlocks)
+            start = endOf(i);
+    }
+    return SYSEX_BUFFER_POOL_BLOCKS;
+}
+
+void SysExBufferPool::insert(uint8_t index, Block block) {
+    for (uint8_t i = numBlocks; i > index; --i)
+        blocks[i] = blocks[i - 1];
+    blocks[index] = block;
+    ++numBlocks;
+}
+
+void SysExBufferPool::remove(uint8_t index) {
+    --numBlocks;
+    for (uint8_t i = index; i < numBlocks; ++i)
+        blocks[i] = blocks[i + 1];
+}
+
+bool SysExBufferPool::reclaimStale() {
+    unsigned long now = millis();
+    bool reclaimed = false;
+    uint8_t i = 0;
+    while (i < numBlocks) {
+        SysExBuffer *owner = blocks[i].owner;
+        if (owner != nullptr && owner->isStale(now)) {
+            DEBUG(F("SysEx: Reclaiming stale buffer"));
+            owner->abandon(); // releases block i
+            reclaimed = true;
+        } else {
+            ++i;
+        }
+    }
+    return reclaimed;
+}
+
+uint8_t *SysExBufferPool::lease(uint16_t size, SysExBuffer *owner) {
+    uint16_t offset;
+    uint8_t index = findGap(size, offset);
+    if (index == SYSEX_BUFFER_POOL_BLOCKS && reclaimStale())
+        index = findGap(size, offset);
+    if (index == SYSEX_BUFFER_POOL_BLOCKS) {
+        DEBUG(F("SysEx: Pool full (") << size << ')');
+        return nullptr;
+    }
+    insert(index, {offset, size, owner});
+    return arena + offset;
+}
+
+uint8_t *SysExBufferPool::resize(uint8_t *block, uint16_t size) {
+    uint8_t index = find(block);
+    if (index == numBlocks)
+        return nullptr; // LCOV_EXCL_LINE
+    Block &b = blocks[index];
+    // Grow or shrink in place if the next block leaves enough room
+    if (startOfNext(index) - b.offset >= size) {
+        b.size = size;
+        return block;
+    }
+    // Move the block down, into the gap before it
+    uint16_t prevEnd = index > 0 ? endOf(index - 1) : 0;
+    if (startOfNext(index) - prevEnd >= size) {
+        memmove(arena + prevEnd, block, b.size);
+        b = {prevEnd, size, b.owner};
+        return arena + prevEnd;
+    }
+    // Move the block to a different gap
+    uint16_t offset;
+    uint8_t newIndex = findGap(size, offset);
+    if (newIndex == SYSEX_BUFFER_POOL_BLOCKS) {
+        DEBUG(F("SysEx: Pool full (") << size << ')');
+        return nullptr;
+    }
+    memcpy(arena + offset, block, b.size);
+    SysExBuffer *owner = b.owner;
+    remove(index);
+    insert(newIndex > index ? newIndex - 1 : newIndex, {offset, size, owner});
+    return arena + offset;
+}
+
+void SysExBufferPool::release(uint8_t *block) {
+    uint8_t index = find(block);
+    if (index < numBlocks)
+        remove(index);
+}
+
+uint16_t SysExBufferPool::getUsedBytes() const {
+    uint16_t used = 0;
+    for (uint8_t i = 0; i < numBlocks; ++i)
+        used += blocks[i].size;
+    return used;
+}
+
+uint16_t SysExBufferPool::getLargestFreeBlock() const {
+    if (numBlocks == SYSEX_BUFFER_POOL_BLOCKS)
+        return 0;
+    uint16_t largest = 0, start = 0;
+    for (uint8_t i = 0; i <= numBlocks; ++i) {
+        uint16_t end = i < numBlocks ? blocks[i].offset : SYSEX_BUFFER_POOL_SIZE;
+        if (end - start > largest)
+            largest = end - start;
+        if (i < numBlocks)
+            start = endOf(i);
+    }
+    return largest;
+}
+
+END_CS_NAMESPACE
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <Settings/SettingsWrapper.hpp>
+
+BEGIN_CS_NAMESPACE
+
+class SysExBuffer;
+
+/**
+ * @brief   Fixed arena of memory that is shared by the SysEx buffers of all
+ *          MIDI parsers.
+ *
+ * A @ref SysExBuffer leases a block of @ref SYSEX_BUFFER_SIZE bytes when a
+ * System Exclusive message starts, grows it when the message doesn't fit,
+ * and returns it to the pool when the message ends. Idle parsers and cables
+ * don't use any memory, and when only one or two messages are being received
+ * at the same time, they can be much longer than @ref SYSEX_BUFFER_SIZE.
+ *
+ * Blocks are allocated first-fit. At most @ref SYSEX_BUFFER_POOL_BLOCKS
+ * blocks can be leased at the same time. When the pool is full, the blocks
+ * of buffers that haven't received any data for @ref SYSEX_CHUNK_TIMEOUT
+ * milliseconds (e.g. because the sender never terminated the message) are
+ * reclaimed, so an unterminated message can't block all other messages.
+ *
+ * @ingroup MIDIParsers
+ */
+class SysExBufferPool {
+  public:
+    /// Lease a block of the given size.
+    /// @param  size
+    ///         The size of the block in bytes.
+    /// @param  owner
+    ///         The buffer the block is leased by. If it becomes stale, the
+    ///         block can be reclaimed (see @ref SysExBuffer::isStale).
+    /// @return A pointer to the block, or `nullptr` if the pool is full.
+    uint8_t *lease(uint16_t size, SysExBuffer *owner = nullptr);
+    /// Change the size of a leased block. The contents are kept, but the block
+    /// may be moved.
+    /// @return A pointer to the resized block, or `nullptr` if there is not
+    ///         enough space (the original block is still valid in that case).
+    uint8_t *resize(uint8_t *block, uint16_t size);
+    /// Return a block to the pool. Its contents stay intact until the memory
+    /// is leased again.
+    void release(uint8_t *block);
+
+    /// Get the number of bytes that are currently leased.
+    uint16_t getUsedBytes() const;
+    /// Get the size of the largest block that could currently be leased.
+    uint16_t getLargestFreeBlock() const;
+    /// Get the number of blocks that are currently leased.
+    uint8_t getNumberOfLeases() const { return numBlocks; }
+    /// Get the total size of the pool.
+    constexpr static uint16_t getSize() { return SYSEX_BUFFER_POOL_SIZE; }
+
+    /// The pool used by all MIDI parsers.
+    static SysExBufferPool &getDefault() { return defaultPool; }
+
+  private:
+    struct Block {
+        uint16_t offset;
+        uint16_t size;
+        SysExBuffer *owner;
+    };
+
+    /// Release the blocks of all stale buffers.
+    /// @return True if at least one block was released.
+    bool reclaimStale();
+
+    /// Find the leased block that starts at the given address.
+    uint8_t find(const uint8_t *block) const;
+    /// Find the first gap of at least the given size.
+    /// @return The index in @ref blocks the new block should be inserted at,
+    ///         or @ref SYSEX_BUFFER_POOL_BLOCKS if there is no such gap.
+    uint8_t findGap(uint16_t size, uint16_t &offset) const;
+    /// The first free byte after the given block.
+    uint16_t endOf(uint8_t index) const {
+        return blocks[index].offset + blocks[index].size;
+    }
+    /// The first byte of the block after the given one.
+    uint16_t startOfNext(uint8_t index) const {
+        return index + 1 < numBlocks ? blocks[index + 1].offset
+                                     : SYSEX_BUFFER_POOL_SIZE;
+    }
+    void insert(uint8_t index, Block block);
+    void remove(uint8_t index);
+
+  private:
+    uint8_t arena[SYSEX_BUFFER_POOL_SIZE];
+    /// The leased blocks, sorted by offset.
+    Block blocks[SYSEX_BUFFER_POOL_BLOCKS];
+    uint8_t numBlocks = 0;
+
+    static SysExBufferPool defaultPool;
+};
+
+END_CS_NAMESPACE
@@ -0,0 +1,174 @@
+#include "SysExPacking.hpp"
+#include <string.h>
+
+BEGIN_CS_NAMESPACE
+
+namespace {
+
+// The bytes are combined into words explicitly (little-endian), compilers
+// turn this into a single load or store on targets that support unaligned
+// access.
+
+inline uint32_t loadWord(const uint8_t *p) {
+    return uint32_t(p[0]) << 0 | uint32_t(p[1]) << 8 | //
+           uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+}
+
+inline void storeWord(uint8_t *p, uint32_t word) {
+    p[0] = word >> 0;
+    p[1] = word >> 8;
+    p[2] = word >> 16;
+    p[3] = word >> 24;
+}
+
+/// Gather the MSBs of the four bytes of a word into the four low bits.
+inline uint8_t gatherMSBs(uint32_t word) {
+    uint32_t msbs = (word >> 7) & 0x01010101;
+    return (msbs | msbs >> 7 | msbs >> 14 | msbs >> 21) & 0x0F;
+}
+
+/// Spread the four low bits to the MSBs of the four bytes of a word.
+inline uint32_t scatterMSBs(uint8_t bits) {
+    uint32_t msbs = bits & 0x0F;
+    return ((msbs | msbs << 7 | msbs << 14 | msbs << 21) & 0x01010101) << 7;
+}
+
+/// Convert between the two orders of the header bits: bit @f$ i @f$ becomes
+/// bit @f$ 6 - i @f$. The kernels use the flipped order (bit @f$ i @f$ is the
+/// MSB of byte @f$ i @f$).
+inline uint8_t reverseHeader(uint8_t bits) {
+    bits = (bits & 0x0F) << 4 | (bits & 0xF0) >> 4;
+    bits = (bits & 0x33) << 2 | (bits & 0xCC) >> 2;
+    bits = (bits & 0x55) << 1 | (bits & 0xAA) >> 1;
+    return bits >> 1;
+}
+
+inline uint8_t orderHeader(uint8_t bits, bool flipHeaderBits) {
+    return flipHeaderBits ? bits : reverseHeader(bits);
+}
+
+/// Pack a full group of seven bytes into eight.
+inline void packGroup(const uint8_t *data, uint8_t *packed, bool flip) {
+    // Bytes 0-3 and 3-6, byte 3 is in both words
+    uint32_t lo = loadWord(data + 0), hi = loadWord(data + 3);
+    uint8_t msbs = gatherMSBs(lo) | (gatherMSBs(hi) & 0x0E) << 3;
+    packed[0] = orderHeader(msbs, flip);
+    storeWord(packed + 1, lo & 0x7F7F7F7F);
+    storeWord(packed + 4, hi & 0x7F7F7F7F);
+}
+
+/// Unpack a full group of eight bytes into seven.
+inline void unpackGroup(const uint8_t *packed, uint8_t *data, bool flip) {
+    uint8_t msbs = orderHeader(packed[0], flip);
+    uint32_t lo = loadWord(packed + 1) & 0x7F7F7F7F;
+    uint32_t hi = loadWord(packed + 4) & 0x7F7F7F7F;
+    // Both words are read before writing, so unpacking in place works
+    storeWord(data + 0, lo | scatterMSBs(msbs));
+    storeWord(data + 3, hi | scatterMSBs(msbs >> 3));
+}
+
+/// Pack an incomplete group of fewer than seven bytes.
+uint8_t packPartialGroup(const uint8_t *data, uint8_t length, uint8_t *packed,
+                         bool flip) {
+    uint8_t msbs = 0;
+    for (uint8_t i = 0; i < length; ++i) {
+        msbs |= (data[i] >> 7) << i;
+        packed[i + 1] = data[i] & 0x7F;
+    }
+    packed[0] = orderHeader(msbs, flip);
+    return length + 1;
+}
+
+} // namespace
+
+// -------------------------------------------------------------------------- //
+
+uint16_t pack8to7(const uint8_t *data, uint16_t length, uint8_t *packed,
+                  bool flipHeaderBits) {
+    const uint8_t *const start = packed;
+    for (; length >= 7; length -= 7, data += 7, packed += 8)
+        packGroup(data, packed, flipHeaderBits);
+    if (length > 0)
+        packed += packPartialGroup(data, length, packed, flipHeaderBits);
+    return packed - start;
+}
+
+uint16_t unpack7to8(const uint8_t *packed, uint16_t length, uint8_t *data,
+                    bool flipHeaderBits) {
+    const uint8_t *const start = data;
+    for (; length >= 8; length -= 8, packed += 8, data += 7)
+        unpackGroup(packed, data, flipHeaderBits);
+    if (length > 0) {
+        uint8_t msbs = orderHeader(packed[0], flipHeaderBits);
+        for (uint8_t i = 1; i < length; ++i)
+            *data++ = (packed[i] & 0x7F) | ((msbs >> (i - 1)) & 0x01) << 7;
+    }
+    return data - start;
+}
+
+// -------------------------------------------------------------------------- //
+
+uint16_t SysExUnpacker::unpack(const uint8_t *chunk, uint16_t length,
+                               uint8_t *data) {
+    const uint8_t *const start = data;
+    const uint8_t *const end = chunk + length;
+    if (chunk != end && *chunk == uint8_t(MIDIMessageType::SysExStart)) {
+        ++chunk;
+        reset();
+    }
+    const uint8_t *dataEnd = end;
+    if (chunk != end && end[-1] == uint8_t(MIDIMessageType::SysExEnd))
+        --dataEnd;
+    while (chunk != dataEnd) {
+        // Full groups at the start of a group are unpacked at once
+        if (index == 0 && dataEnd - chunk >= 8) {
+            unpackGroup(chunk, data, flipHeaderBits);
+            chunk += 8;
+            data += 7;
+            continue;
+        }
+        uint8_t byte = *chunk++;
+        if (index == 0)
+            msbs = orderHeader(byte, flipHeaderBits);
+        else
+            *data++ = (byte & 0x7F) | ((msbs >> (index - 1)) & 0x01) << 7;
+        index = index == 7 ? 0 : index + 1;
+    }
+    return data - start;
+}
+
+// -------------------------------------------------------------------------- //
+
+uint16_t SysExPacker::pack(const uint8_t *data, uint16_t length,
+                           uint8_t *packed) {
+    uint8_t *const start = packed;
+    // Complete the group that was kept from the previous call
+    if (numPending > 0) {
+        uint8_t missing = 7 - numPending;
+        if (length < missing) {
+            memcpy(pending + numPending, data, length);
+            numPending += length;
+            return 0;
+        }
+        memcpy(pending + numPending, data, missing);
+        packGroup(pending, packed, flipHeaderBits);
+        packed += 8;
+        data += missing;
+        length -= missing;
+    }
+    for (; length >= 7; length -= 7, data += 7, packed += 8)
+        packGroup(data, packed, flipHeaderBits);
+    memcpy(pending, data, length);
+    numPending = length;
+    return packed - start;
+}
+
+uint8_t SysExPacker::flush(uint8_t *packed) {
+    uint8_t length = numPending;
+    numPending = 0;
+    return length > 0
+               ? packPartialGroup(pending, length, packed, flipHeaderBits)
+               : 0;
+}
+
+END_CS_NAMESPACE
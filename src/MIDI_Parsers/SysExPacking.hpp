@@ -0,0 +1,175 @@
+#pragma once
+
+#include "MIDI_MessageTypes.hpp"
+#include <Settings/SettingsWrapper.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/// @addtogroup MIDIParsers
+/// @{
+
+/// @name   Packing binary data into System Exclusive messages
+///
+/// SysEx data bytes only have seven bits, so arbitrary 8-bit data has to be
+/// packed: every group of up to seven bytes is preceded by a byte containing
+/// their most significant bits, followed by the seven low bits of each byte.
+/// By default, bit @f$ 6 - i @f$ of the header is the MSB of byte @f$ i @f$ of
+/// the group. This is the same encoding as the `encodeSysEx` and
+/// `decodeSysEx` functions of the Arduino MIDI library. With
+/// `flipHeaderBits`, bit @f$ i @f$ is the MSB of byte @f$ i @f$ instead, like
+/// their `inFlipHeaderBits` option (used by Korg, among others).
+///
+/// Full groups are handled four bytes at a time, using 32-bit word
+/// operations.
+/// @{
+
+/// Get the number of 7-bit bytes that `length` 8-bit bytes are packed into.
+constexpr uint16_t packed8to7Length(uint16_t length) {
+    return length + (length + 6) / 7;
+}
+
+/// Get the number of 8-bit bytes that `length` 7-bit bytes unpack to.
+constexpr uint16_t unpacked7to8Length(uint16_t length) {
+    return length - (length + 7) / 8;
+}
+
+/**
+ * @brief   Pack 8-bit data into 7-bit SysEx data bytes.
+ *
+ * @param   data
+ *          The 8-bit data to pack.
+ * @param   length
+ *          The number of bytes in @p data.
+ * @param   packed
+ *          The output buffer, must have room for
+ *          @ref packed8to7Length "packed8to7Length(length)" bytes. It must
+ *          not overlap with the input.
+ * @param   flipHeaderBits
+ *          Store the MSB of byte @f$ i @f$ of a group in bit @f$ i @f$ of its
+ *          header instead of in bit @f$ 6 - i @f$.
+ * @return  The number of bytes written to @p packed.
+ */
+uint16_t pack8to7(const uint8_t *data, uint16_t length, uint8_t *packed,
+                  bool flipHeaderBits = false);
+
+/**
+ * @brief   Unpack 7-bit SysEx data bytes into the original 8-bit data.
+ *
+ * The most significant bits of the packed bytes are ignored, so the SysEx
+ * start and end bytes must not be included.
+ *
+ * @param   packed
+ *          The 7-bit data to unpack.
+ * @param   length
+ *          The number of bytes in @p packed.
+ * @param   data
+ *          The output buffer, must have room for
+ *          @ref unpacked7to8Length "unpacked7to8Length(length)" bytes. It
+ *          may be the same as @p packed (the data is unpacked in place), but
+ *          it must not overlap otherwise.
+ * @param   flipHeaderBits
+ *          The MSB of byte @f$ i @f$ of a group is stored in bit @f$ i @f$ of
+ *          its header instead of in bit @f$ 6 - i @f$.
+ * @return  The number of bytes written to @p data.
+ */
+uint16_t unpack7to8(const uint8_t *packed, uint16_t length, uint8_t *data,
+                    bool flipHeaderBits = false);
+
+/// @}
+
+/**
+ * @brief   Unpacks binary data from a SysEx message that arrives in chunks.
+ *
+ * The chunks are the @ref SysExMessage "SysExMessages" passed to the
+ * `onSysExMessage` callbacks when a message doesn't fit in the receive buffer,
+ * or when it's received from multiple cables at the same time. Groups of
+ * packed bytes may be split across chunks, the unpacker keeps track of the
+ * group that is in progress, and unpacks the bytes of each chunk as soon as
+ * they arrive.
+ *
+ * Every chunk must be unpacked in the order it was received. The SysEx start
+ * byte resets the unpacker, the SysEx end byte is skipped.
+ *
+ * @see @ref pack8to7, @ref unpack7to8
+ */
+class SysExUnpacker {
+  public:
+    /// @param  flipHeaderBits
+    ///         See @ref unpack7to8.
+    SysExUnpacker(bool flipHeaderBits = false)
+        : flipHeaderBits(flipHeaderBits) {}
+
+    /// Unpack the data bytes of a chunk of a SysEx message.
+    /// @param   chunk
+    ///          The chunk to unpack.
+    /// @param   data
+    ///          The output buffer, must have room for `chunk.length` bytes.
+    ///          It may be the same as `chunk.data`.
+    /// @return  The number of bytes written to @p data.
+    uint16_t unpack(SysExMessage chunk, uint8_t *data) {
+        return unpack(chunk.data, chunk.length, data);
+    }
+    /// @copydoc unpack(SysExMessage, uint8_t *)
+    uint16_t unpack(const uint8_t *chunk, uint16_t length, uint8_t *data);
+
+    /// Forget the group in progress, for when a message is aborted.
+    void reset() { index = 0; }
+
+  private:
+    /// The MSBs of the current group.
+    uint8_t msbs = 0;
+    /// The index of the next byte in the current group, zero for the MSBs.
+    uint8_t index = 0;
+    bool flipHeaderBits;
+};
+
+/**
+ * @brief   Packs binary data that is produced in pieces, so it can be sent as
+ *          a SysEx message in chunks.
+ *
+ * Since the MSBs of a group come first, up to six bytes are kept until their
+ * group is complete, or until @ref flush is called.
+ *
+ * @see @ref pack8to7, @ref unpack7to8
+ */
+class SysExPacker {
+  public:
+    /// @param  flipHeaderBits
+    ///         See @ref pack8to7.
+    SysExPacker(bool flipHeaderBits = false)
+        : flipHeaderBits(flipHeaderBits) {}
+
+    /// Get the size of the output buffer for packing `length` bytes.
+    constexpr static uint16_t maxPackedLength(uint16_t length) {
+        return packed8to7Length(length + 6);
+    }
+
+    /// Pack the given data, and the bytes that were kept from the previous
+    /// call. The remaining bytes of an incomplete group are kept.
+    /// @param   data
+    ///          The 8-bit data to pack.
+    /// @param   length
+    ///          The number of bytes in @p data.
+    /// @param   packed
+    ///          The output buffer, must have room for
+    ///          @ref maxPackedLength "maxPackedLength(length)" bytes.
+    /// @return  The number of bytes written to @p packed.
+    uint16_t pack(const uint8_t *data, uint16_t length, uint8_t *packed);
+
+    /// Pack the incomplete group that was kept (the final chunk of the
+    /// message).
+    /// @param   packed
+    ///          The output buffer, must have room for 7 bytes.
+    /// @return  The number of bytes written to @p packed.
+    uint8_t flush(uint8_t *packed);
+
+  private:
+    /// The bytes of the incomplete group, one extra to complete it.
+    uint8_t pending[7];
+    uint8_t numPending = 0;
+    bool flipHeaderBits;
+};
+
+/// @}
+
+END_CS_NAMESPACE
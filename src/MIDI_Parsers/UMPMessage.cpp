@@ -0,0 +1,67 @@
+#include "UMPMessage.hpp"
+
+BEGIN_CS_NAMESPACE
+
+uint8_t UMPMessage::getNumberOfWords(uint32_t firstWord) {
+    // The number of words minus one, two bits per message type, starting
+    // with type 0x0 in the least significant bits:
+    // 0 0 0 1 | 1 3 0 0 | 1 1 1 2 | 2 3 3 3
+    constexpr uint32_t sizes = 0xFE950D40;
+    return ((sizes >> (2 * (firstWord >> 28))) & 0x3) + 1;
+}
+
+uint8_t UMPMessage::toBytes(uint8_t *buffer) const {
+    uint8_t numWords = getNumberOfWords();
+    if (numWords > 2) // Larger packets are not supported
+        numWords = 2;
+    for (uint8_t w = 0; w < numWords; ++w) {
+        *buffer++ = words[w] >> 24;
+        *buffer++ = words[w] >> 16;
+        *buffer++ = words[w] >> 8;
+        *buffer++ = words[w] >> 0;
+    }
+    return 4 * numWords;
+}
+
+uint32_t scaleUpMIDIValue(uint32_t value, uint8_t srcBits, uint8_t dstBits) {
+    uint8_t scaleBits = dstBits - srcBits;
+    uint32_t shifted = value << scaleBits;
+    // Values up to the center are simply shifted
+    uint32_t srcCenter = uint32_t(1) << (srcBits - 1);
+    if (value <= srcCenter)
+        return shifted;
+    // Values above the center repeat their bits below the center bit, so
+    // that the maximum maps to the maximum
+    uint8_t repeatBits = srcBits - 1;
+    uint32_t repeatMask = (uint32_t(1) << repeatBits) - 1;
+    uint32_t repeatValue = value & repeatMask;
+    if (scaleBits > repeatBits)
+        repeatValue <<= scaleBits - repeatBits;
+    else
+        repeatValue >>= repeatBits - scaleBits;
+    while (repeatValue != 0) {
+        shifted |= repeatValue;
+        repeatValue >>= repeatBits;
+    }
+    return shifted;
+}
+
+#ifndef ARDUINO
+std::ostream &operator<<(std::ostream &os, UMPMessage m) {
+    uint8_t buffer[8];
+    uint8_t length = m.toBytes(buffer);
+    os << "UMPMessage [" << +length << "] " << AH::HexDump(buffer, length)
+       << " (group " << +m.getCable().getOneBased() << ")";
+    return os;
+}
+#endif
+
+Print &operator<<(Print &os, UMPMessage m) {
+    uint8_t buffer[8];
+    uint8_t length = m.toBytes(buffer);
+    os << "UMPMessage [" << length << "] " << AH::HexDump(buffer, length)
+       << " (group " << m.getCable().getOneBased() << ")";
+    return os;
+}
+
+END_CS_NAMESPACE
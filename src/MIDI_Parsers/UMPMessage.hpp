@@ -0,0 +1,176 @@
+#pragma once
+
+#include "MIDI_MessageTypes.hpp"
+
+BEGIN_CS_NAMESPACE
+
+/// The type of a Universal MIDI Packet, stored in its four most significant
+/// bits. The type determines the size of the packet.
+enum class UMPMessageType : uint8_t {
+    Utility = 0x0,              ///< NOOP and Jitter Reduction (32 bits).
+    SystemRealTimeCommon = 0x1, ///< System Common and Real-Time (32 bits).
+    MIDI1ChannelVoice = 0x2,    ///< MIDI 1.0 Channel Voice messages (32 bits).
+    Data64 = 0x3,               ///< System Exclusive 7-bit data (64 bits).
+    MIDI2ChannelVoice = 0x4,    ///< MIDI 2.0 Channel Voice messages (64 bits).
+    Data128 = 0x5,              ///< System Exclusive 8-bit data (128 bits).
+};
+
+/// The status (opcode) of a MIDI 2.0 Channel Voice message.
+enum class MIDI2Status : uint8_t {
+    RegisteredPerNoteController = 0x00, ///< Registered Per-Note Controller.
+    AssignablePerNoteController = 0x10, ///< Assignable Per-Note Controller.
+    RegisteredController = 0x20,   ///< Registered Controller (RPN).
+    AssignableController = 0x30,   ///< Assignable Controller (NRPN).
+    RelativeRegisteredController = 0x40, ///< Relative Registered Controller.
+    RelativeAssignableController = 0x50, ///< Relative Assignable Controller.
+    PerNotePitchBend = 0x60,       ///< Per-Note Pitch Bend.
+    NoteOff = 0x80,                ///< Note Off (16-bit velocity).
+    NoteOn = 0x90,                 ///< Note On (16-bit velocity).
+    KeyPressure = 0xA0,            ///< Polyphonic Key Pressure (32 bits).
+    ControlChange = 0xB0,          ///< Control Change (32 bits).
+    ProgramChange = 0xC0,          ///< Program Change (with optional bank).
+    ChannelPressure = 0xD0,        ///< Channel Pressure (32 bits).
+    PitchBend = 0xE0,              ///< Pitch Bend (32 bits).
+    PerNoteManagement = 0xF0,      ///< Per-Note Management.
+};
+
+/// The status of a System Exclusive 7-bit data packet, which says which part
+/// of a System Exclusive message the packet carries.
+enum class UMPSysExStatus : uint8_t {
+    Complete = 0x0, ///< The complete message, in a single packet.
+    Start = 0x1,    ///< The first packet of a message.
+    Continue = 0x2, ///< A packet in the middle of a message.
+    End = 0x3,      ///< The last packet of a message.
+};
+
+/**
+ * @brief   A 32-bit or 64-bit Universal MIDI Packet, as used by MIDI 2.0.
+ *
+ * The first word contains the message type, the group, the status and the
+ * first data bytes, the second word (if any) contains the rest of the data,
+ * e.g. the full 32-bit value of a MIDI 2.0 Control Change message. The 16
+ * groups are mapped to the 16 virtual MIDI cables.
+ *
+ * Packets of 96 or 128 bits (8-bit System Exclusive data, Flex Data and UMP
+ * Stream messages) are not supported.
+ *
+ * @ingroup MIDIParsers
+ */
+struct UMPMessage {
+    /// Constructor.
+    UMPMessage(uint32_t word0 = 0, uint32_t word1 = 0) : words {word0, word1} {}
+
+    /// The packet, the first word contains the message type.
+    uint32_t words[2];
+
+    bool operator==(UMPMessage other) const {
+        return this->words[0] == other.words[0] &&
+               (getNumberOfWords() < 2 || this->words[1] == other.words[1]);
+    }
+    bool operator!=(UMPMessage other) const { return !(*this == other); }
+
+    /// Get the type of the packet.
+    UMPMessageType getMessageType() const {
+        return static_cast<UMPMessageType>(words[0] >> 28);
+    }
+    /// Get the number of 32-bit words in the packet.
+    uint8_t getNumberOfWords() const { return getNumberOfWords(words[0]); }
+    /// Get the number of 32-bit words of the packet that starts with the
+    /// given word, between one and four.
+    static uint8_t getNumberOfWords(uint32_t firstWord);
+
+    /// Get the group of the packet as a MIDI USB cable number.
+    Cable getCable() const { return Cable((words[0] >> 24) & 0x0F); }
+    /// Set the group of the packet using a MIDI USB cable number.
+    void setCable(Cable cable) {
+        words[0] = (words[0] & 0xF0FFFFFF) | uint32_t(cable.getRaw()) << 24;
+    }
+
+    /// Get the status byte. For channel voice messages, this includes the
+    /// channel.
+    uint8_t getStatus() const { return words[0] >> 16; }
+    /// Get the MIDI channel of a channel voice message.
+    Channel getChannel() const { return Channel((words[0] >> 16) & 0x0F); }
+    /// Get the channel and cable of a channel voice message.
+    MIDIChannelCable getChannelCable() const {
+        return {getChannel(), getCable()};
+    }
+    /// Get the third byte of the first word (e.g. the note or controller).
+    uint8_t getData1() const { return words[0] >> 8; }
+    /// Get the last byte of the first word.
+    uint8_t getData2() const { return words[0] >> 0; }
+    /// Get the 32-bit data word of a 64-bit packet.
+    uint32_t getData32() const { return words[1]; }
+
+    /**
+     * @brief   Write the packet to the given buffer in network byte order
+     *          (big-endian), as used by UMP streams and files.
+     * @param   buffer
+     *          The buffer to write to, at least eight bytes long.
+     * @return  The number of bytes written (four or eight).
+     */
+    uint8_t toBytes(uint8_t *buffer) const;
+
+    /// @name Creating packets
+    /// @{
+
+    /// Create a MIDI 2.0 Channel Voice message.
+    static UMPMessage midi2(MIDI2Status status, MIDIChannelCable address,
+                            uint8_t index1, uint8_t index2, uint32_t data) {
+        return {uint32_t(UMPMessageType::MIDI2ChannelVoice) << 28 |
+                    uint32_t(address.getRawCableNumber()) << 24 |
+                    uint32_t(uint8_t(status) | address.getRawChannel()) << 16 |
+                    uint32_t(index1 & 0x7F) << 8 | index2,
+                data};
+    }
+    /// Create a MIDI 2.0 Control Change message with a 32-bit value.
+    static UMPMessage controlChange(MIDIAddress address, uint32_t value) {
+        return midi2(MIDI2Status::ControlChange, address.getChannelCable(),
+                     address.getAddress(), 0x00, value);
+    }
+    /// Create a MIDI 2.0 Registered (RPN) or Assignable (NRPN) Controller
+    /// message with a 14-bit parameter number and a 32-bit value.
+    static UMPMessage parameter(MIDIChannelCable address, bool registered,
+                                uint16_t number, uint32_t value) {
+        return midi2(registered ? MIDI2Status::RegisteredController
+                                : MIDI2Status::AssignableController,
+                     address, number >> 7, number & 0x7F, value);
+    }
+
+    /// @}
+};
+
+/// @name Scaling values between MIDI 1.0 and MIDI 2.0 resolutions
+/// @{
+
+/**
+ * @brief   Increase the resolution of a value, using the min-center-max
+ *          algorithm of the MIDI 2.0 specification.
+ *
+ * The minimum, center and maximum values of the source range map to the
+ * minimum, center and maximum of the destination range, e.g. 7-bit 64 maps
+ * to 32-bit 0x80000000, and 127 maps to 0xFFFFFFFF.
+ *
+ * @param   value
+ *          The value to scale up, at most @p srcBits wide.
+ * @param   srcBits
+ *          The resolution of @p value, at least 2 bits.
+ * @param   dstBits
+ *          The resolution of the result, at most 32 bits.
+ */
+uint32_t scaleUpMIDIValue(uint32_t value, uint8_t srcBits, uint8_t dstBits);
+
+/// Decrease the resolution of a value, as specified by MIDI 2.0.
+inline uint32_t scaleDownMIDIValue(uint32_t value, uint8_t srcBits,
+                                   uint8_t dstBits) {
+    return value >> (srcBits - dstBits);
+}
+
+/// @}
+
+#ifndef ARDUINO
+std::ostream &operator<<(std::ostream &os, UMPMessage m);
+#endif
+Print &operator<<(Print &os, UMPMessage m);
+
+END_CS_NAMESPACE
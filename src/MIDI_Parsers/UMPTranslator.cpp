@@ -0,0 +1,263 @@
+#include "UMPTranslator.hpp"
+#include <MIDI_Constants/Control_Change.hpp>
+
+BEGIN_CS_NAMESPACE
+
+// -------------------------------------------------------------------------- //
+
+// Universal MIDI Packets to MIDI 1.0
+
+uint8_t UMPToMIDI1Translator::translate(UMPMessage msg) {
+    count = 0;
+    switch (msg.getMessageType()) {
+        case UMPMessageType::SystemRealTimeCommon: {
+            uint8_t status = msg.getStatus();
+            if (status >= uint8_t(MIDIMessageType::TimingClock))
+                add(RealTimeMessage(status, msg.getCable()));
+            else if (status > uint8_t(MIDIMessageType::SysExStart) &&
+                     status < uint8_t(MIDIMessageType::SysExEnd))
+                add(SysCommonMessage(MIDIMessage(status, msg.getData1(),
+                                                 msg.getData2(),
+                                                 msg.getCable())));
+        } break;
+        case UMPMessageType::MIDI1ChannelVoice: {
+            MIDIMessage m(msg.getStatus(), msg.getData1(), msg.getData2(),
+                          msg.getCable());
+            if (m.hasValidChannelMessageHeader())
+                add(ChannelMessage(m));
+        } break;
+        case UMPMessageType::Data64: translateSysEx(msg); break;
+        case UMPMessageType::MIDI2ChannelVoice: translateMIDI2(msg); break;
+        case UMPMessageType::Utility: // fallthrough
+        case UMPMessageType::Data128: // fallthrough
+        default: break;
+    }
+    return count;
+}
+
+void UMPToMIDI1Translator::translateSysEx(UMPMessage msg) {
+    auto status = static_cast<UMPSysExStatus>(msg.getStatus() >> 4);
+    uint8_t numBytes = msg.getStatus() & 0x0F;
+    if (numBytes > 6 || uint8_t(status) > uint8_t(UMPSysExStatus::End))
+        return;
+    bool start = status == UMPSysExStatus::Complete ||
+                 status == UMPSysExStatus::Start;
+    bool end = status == UMPSysExStatus::Complete ||
+               status == UMPSysExStatus::End;
+    uint8_t length = 0;
+    if (start)
+        sysexData[length++] = uint8_t(MIDIMessageType::SysExStart);
+    for (uint8_t i = 0; i < numBytes; ++i) {
+        uint32_t word = msg.words[(i + 2) / 4];
+        uint8_t shift = 24 - 8 * ((i + 2) % 4);
+        sysexData[length++] = (word >> shift) & 0x7F;
+    }
+    if (end)
+        sysexData[length++] = uint8_t(MIDIMessageType::SysExEnd);
+    if (length > 0)
+        add(SysExMessage(sysexData, length, msg.getCable()));
+}
+
+void UMPToMIDI1Translator::addControlChange(UMPMessage msg, uint8_t controller,
+                                            uint8_t value) {
+    add(ChannelMessage(MIDIMessageType::ControlChange, msg.getChannel(),
+                       controller, value, msg.getCable()));
+}
+
+void UMPToMIDI1Translator::translateMIDI2(UMPMessage msg) {
+    using MMT = MIDIMessageType;
+    uint32_t data = msg.getData32();
+    Channel channel = msg.getChannel();
+    Cable cable = msg.getCable();
+    uint8_t index = msg.getData1() & 0x7F;
+    switch (static_cast<MIDI2Status>(msg.getStatus() & 0xF0)) {
+        case MIDI2Status::NoteOff:
+            add(ChannelMessage(MMT::NoteOff, channel, index,
+                               scaleDownMIDIValue(data >> 16, 16, 7), cable));
+            break;
+        case MIDI2Status::NoteOn: {
+            // A velocity of zero would turn it into a Note Off
+            uint8_t velocity = scaleDownMIDIValue(data >> 16, 16, 7);
+            add(ChannelMessage(MMT::NoteOn, channel, index,
+                               velocity == 0 ? 1 : velocity, cable));
+        } break;
+        case MIDI2Status::KeyPressure:
+            add(ChannelMessage(MMT::KeyPressure, channel, index,
+                               scaleDownMIDIValue(data, 32, 7), cable));
+            break;
+        case MIDI2Status::ControlChange:
+            addControlChange(msg, index, scaleDownMIDIValue(data, 32, 7));
+            break;
+        case MIDI2Status::ProgramChange:
+            if (msg.getData2() & 0x01) { // Bank valid
+                addControlChange(msg, MIDI_CC::Bank_Select, (data >> 8) & 0x7F);
+                addControlChange(msg, MIDI_CC::Bank_Select_LSB, data & 0x7F);
+            }
+            add(ChannelMessage(MMT::ProgramChange, channel, (data >> 24) & 0x7F,
+                               0x00, cable));
+            break;
+        case MIDI2Status::ChannelPressure:
+            add(ChannelMessage(MMT::ChannelPressure, channel,
+                               scaleDownMIDIValue(data, 32, 7), 0x00, cable));
+            break;
+        case MIDI2Status::PitchBend: {
+            uint16_t bend = scaleDownMIDIValue(data, 32, 14);
+            add(ChannelMessage(MMT::PitchBend, channel, bend & 0x7F, bend >> 7,
+                               cable));
+        } break;
+        case MIDI2Status::RegisteredController: // fallthrough
+        case MIDI2Status::AssignableController: {
+            bool registered = (msg.getStatus() & 0xF0) ==
+                              uint8_t(MIDI2Status::RegisteredController);
+            uint16_t value = scaleDownMIDIValue(data, 32, 14);
+            addControlChange(msg, registered ? MIDI_CC::RPN_MSB
+                                             : MIDI_CC::NRPN_MSB,
+                             msg.getData1() & 0x7F);
+            addControlChange(msg, registered ? MIDI_CC::RPN_LSB
+                                             : MIDI_CC::NRPN_LSB,
+                             msg.getData2() & 0x7F);
+            addControlChange(msg, MIDI_CC::Data_Entry_MSB, value >> 7);
+            addControlChange(msg, MIDI_CC::Data_Entry_MSB_LSB, value & 0x7F);
+        } break;
+        case MIDI2Status::RegisteredPerNoteController:  // fallthrough
+        case MIDI2Status::AssignablePerNoteController:  // fallthrough
+        case MIDI2Status::RelativeRegisteredController: // fallthrough
+        case MIDI2Status::RelativeAssignableController: // fallthrough
+        case MIDI2Status::PerNotePitchBend:             // fallthrough
+        case MIDI2Status::PerNoteManagement:            // fallthrough
+        default: break;
+    }
+}
+
+// -------------------------------------------------------------------------- //
+
+// MIDI 1.0 to Universal MIDI Packets
+
+void MIDI1ToUMPTranslator::reset() {
+    parameterNumbers.reset();
+    sysexActive = 0;
+}
+
+bool MIDI1ToUMPTranslator::translateChannelMessage(ChannelMessage msg,
+                                                   UMPMessage &packet) {
+    using MMT = MIDIMessageType;
+    MIDIChannelCable address = msg.getChannelCable();
+    uint8_t d1 = msg.getData1(), d2 = msg.getData2();
+    if (protocol == UMPProtocol::MIDI1) {
+        packet = {uint32_t(UMPMessageType::MIDI1ChannelVoice) << 28 |
+                  uint32_t(msg.getCable().getRaw()) << 24 |
+                  uint32_t(msg.header) << 16 | uint32_t(d1) << 8 |
+                  (msg.hasTwoDataBytes() ? d2 : 0x00)};
+        return true;
+    }
+    switch (msg.getMessageType()) {
+        case MMT::NoteOff:
+            packet = UMPMessage::midi2(MIDI2Status::NoteOff, address, d1, 0x00,
+                                       scaleUpMIDIValue(d2, 7, 16) << 16);
+            return true;
+        case MMT::NoteOn:
+            // MIDI 2.0 has no running Note Off, it uses the default release
+            // velocity of 64 instead
+            packet = d2 == 0 ? UMPMessage::midi2(MIDI2Status::NoteOff, address,
+                                                 d1, 0x00, 0x8000ul << 16)
+                             : UMPMessage::midi2(MIDI2Status::NoteOn, address,
+                                                 d1, 0x00,
+                                                 scaleUpMIDIValue(d2, 7, 16)
+                                                     << 16);
+            return true;
+        case MMT::KeyPressure:
+            packet = UMPMessage::midi2(MIDI2Status::KeyPressure, address, d1,
+                                       0x00, scaleUpMIDIValue(d2, 7, 32));
+            return true;
+        case MMT::ControlChange:
+            if (ParameterNumberAssembler::isParameterNumberController(d1)) {
+                if (!parameterNumbers.feed(msg))
+                    return false;
+                ParameterNumberMessage p = parameterNumbers.getMessage();
+                packet = UMPMessage::parameter(p.address, p.registered,
+                                               p.number,
+                                               scaleUpMIDIValue(p.value, 14, 32));
+                return true;
+            }
+            packet = UMPMessage::midi2(MIDI2Status::ControlChange, address, d1,
+                                       0x00, scaleUpMIDIValue(d2, 7, 32));
+            return true;
+        case MMT::ProgramChange:
+            packet = UMPMessage::midi2(MIDI2Status::ProgramChange, address,
+                                       0x00, 0x00, uint32_t(d1) << 24);
+            return true;
+        case MMT::ChannelPressure:
+            packet = UMPMessage::midi2(MIDI2Status::ChannelPressure, address,
+                                       0x00, 0x00, scaleUpMIDIValue(d1, 7, 32));
+            return true;
+        case MMT::PitchBend:
+            packet = UMPMessage::midi2(
+                MIDI2Status::PitchBend, address, 0x00, 0x00,
+                scaleUpMIDIValue(msg.getData14bit(), 14, 32));
+            return true;
+        default: return false;
+    }
+}
+
+UMPMessage MIDI1ToUMPTranslator::systemMessage(uint8_t status, uint8_t data1,
+                                               uint8_t data2, Cable cable) {
+    return {uint32_t(UMPMessageType::SystemRealTimeCommon) << 28 |
+            uint32_t(cable.getRaw()) << 24 | uint32_t(status) << 16 |
+            uint32_t(data1 & 0x7F) << 8 | (data2 & 0x7F)};
+}
+
+auto MIDI1ToUMPTranslator::beginSysEx(SysExMessage msg) -> SysExCursor {
+    SysExCursor cursor {msg.data, msg.length, msg.cable, false, false, false};
+    uint16_t cableBit = 1u << msg.cable.getRaw();
+    if (cursor.remaining > 0 &&
+        cursor.data[0] == uint8_t(MIDIMessageType::SysExStart)) {
+        cursor.start = true;
+        ++cursor.data;
+        --cursor.remaining;
+    } else if (!(sysexActive & cableBit)) {
+        // A chunk without a message to continue
+        cursor.done = true;
+        return cursor;
+    }
+    if (cursor.remaining > 0 && cursor.data[cursor.remaining - 1] ==
+                                    uint8_t(MIDIMessageType::SysExEnd)) {
+        cursor.end = true;
+        --cursor.remaining;
+    }
+    if (cursor.end)
+        sysexActive &= ~cableBit;
+    else
+        sysexActive |= cableBit;
+    return cursor;
+}
+
+bool MIDI1ToUMPTranslator::nextSysEx(SysExCursor &cursor, UMPMessage &packet) {
+    if (cursor.done)
+        return false;
+    uint8_t numBytes = cursor.remaining < 6 ? cursor.remaining : 6;
+    bool first = cursor.start;
+    bool last = cursor.end && cursor.remaining <= 6;
+    // Empty chunks in the middle of a message don't need a packet
+    if (numBytes == 0 && !first && !last) {
+        cursor.done = true;
+        return false;
+    }
+    UMPSysExStatus status = first && last ? UMPSysExStatus::Complete
+                            : first       ? UMPSysExStatus::Start
+                            : last        ? UMPSysExStatus::End
+                                          : UMPSysExStatus::Continue;
+    packet = {uint32_t(UMPMessageType::Data64) << 28 |
+              uint32_t(cursor.cable.getRaw()) << 24 |
+              uint32_t(uint8_t(status) << 4 | numBytes) << 16};
+    for (uint8_t i = 0; i < numBytes; ++i) {
+        uint8_t shift = 24 - 8 * ((i + 2) % 4);
+        packet.words[(i + 2) / 4] |= uint32_t(cursor.data[i] & 0x7F) << shift;
+    }
+    cursor.data += numBytes;
+    cursor.remaining -= numBytes;
+    cursor.start = false;
+    cursor.done = cursor.remaining == 0;
+    return true;
+}
+
+END_CS_NAMESPACE
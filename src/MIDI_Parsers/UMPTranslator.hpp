@@ -0,0 +1,174 @@
+#pragma once
+
+#include "AnyMIDI_Message.hpp"
+#include "ParameterNumberAssembler.hpp"
+#include "UMPMessage.hpp"
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   Translates Universal MIDI Packets to MIDI 1.0 messages, so MIDI 2.0
+ *          input can reach MIDI 1.0 sinks.
+ *
+ * - MIDI 1.0 Channel Voice, System Common and Real-Time packets are unpacked.
+ * - MIDI 2.0 Channel Voice messages are scaled down to their MIDI 1.0
+ *   resolution. Registered and Assignable Controllers become RPN and NRPN
+ *   sequences of four Control Change messages, and a Program Change with a
+ *   valid bank is preceded by the two Bank Select controllers.
+ * - System Exclusive 7-bit packets become chunks of a SysEx message, with the
+ *   SysEx start and end bytes added to the first and last ones.
+ * - Utility messages and MIDI 2.0 messages that don't exist in MIDI 1.0
+ *   (per-note and relative controllers) are dropped.
+ *
+ * The translated messages, and the data of SysEx chunks, are valid until the
+ * next translation.
+ *
+ * @ingroup MIDIParsers
+ */
+class UMPToMIDI1Translator {
+  public:
+    /// The maximum number of MIDI 1.0 messages a single packet turns into.
+    constexpr static uint8_t MaxMessages = 4;
+
+    /// Translate the given packet.
+    /// @return The number of MIDI 1.0 messages, zero if the packet has no
+    ///         MIDI 1.0 equivalent.
+    uint8_t translate(UMPMessage msg);
+
+    /// Get the number of messages of the latest translation.
+    uint8_t getNumberOfMessages() const { return count; }
+    /// Get one of the messages of the latest translation.
+    const AnyMIDIMessage &getMessage(uint8_t index) const {
+        return messages[index];
+    }
+
+    /// Call `target(msg)` for every message of the latest translation, in
+    /// order. The target should accept @ref ChannelMessage,
+    /// @ref SysExMessage, @ref SysCommonMessage and @ref RealTimeMessage.
+    template <class Target>
+    void forEachMessage(Target &&target) const;
+
+  private:
+    template <class Message>
+    void add(Message msg) {
+        messages[count++] = AnyMIDIMessage(msg, 0xFFFF);
+    }
+    void addControlChange(UMPMessage msg, uint8_t controller, uint8_t value);
+    void translateSysEx(UMPMessage msg);
+    void translateMIDI2(UMPMessage msg);
+
+    AnyMIDIMessage messages[MaxMessages];
+    uint8_t count = 0;
+    /// The data of the latest SysEx chunk: up to six bytes, the start and
+    /// the end byte.
+    uint8_t sysexData[8];
+};
+
+template <class Target>
+void UMPToMIDI1Translator::forEachMessage(Target &&target) const {
+    for (uint8_t i = 0; i < count; ++i) {
+        const AnyMIDIMessage::Message &msg = messages[i].message;
+        switch (messages[i].eventType) {
+            case MIDIReadEvent::CHANNEL_MESSAGE:
+                target(msg.channelmessage);
+                break;
+            case MIDIReadEvent::SYSEX_CHUNK: // fallthrough
+            case MIDIReadEvent::SYSEX_MESSAGE: target(msg.sysexmessage); break;
+            case MIDIReadEvent::SYSCOMMON_MESSAGE:
+                target(msg.syscommonmessage);
+                break;
+            case MIDIReadEvent::REALTIME_MESSAGE:
+                target(msg.realtimemessage);
+                break;
+            case MIDIReadEvent::NO_MESSAGE: break; // LCOV_EXCL_LINE
+            default: break;                        // LCOV_EXCL_LINE
+        }
+    }
+}
+
+/// The protocol used for Channel Voice messages in Universal MIDI Packets.
+enum class UMPProtocol : uint8_t {
+    MIDI1, ///< MIDI 1.0 Channel Voice packets (32 bits), unchanged values.
+    MIDI2, ///< MIDI 2.0 Channel Voice packets (64 bits), scaled up values.
+};
+
+/**
+ * @brief   Translates MIDI 1.0 messages to Universal MIDI Packets, so MIDI 1.0
+ *          messages can be sent to MIDI 2.0 hosts.
+ *
+ * With the MIDI 2.0 protocol, the values of Channel Voice messages are scaled
+ * up using the min-center-max algorithm, and the Control Change sequences
+ * of RPNs and NRPNs are assembled into single Registered and Assignable
+ * Controller messages. Bank Select is passed on as a Control Change.
+ *
+ * System Exclusive messages (or chunks of them) are split into 64-bit
+ * packets of up to six data bytes each. The translator keeps track of
+ * unfinished messages per cable, so a message can be translated chunk by
+ * chunk.
+ *
+ * @ingroup MIDIParsers
+ */
+class MIDI1ToUMPTranslator {
+  public:
+    /// Constructor.
+    MIDI1ToUMPTranslator(UMPProtocol protocol = UMPProtocol::MIDI2)
+        : protocol(protocol) {}
+
+    /// Select the protocol for Channel Voice messages.
+    void setProtocol(UMPProtocol protocol) { this->protocol = protocol; }
+    /// Get the protocol for Channel Voice messages.
+    UMPProtocol getProtocol() const { return protocol; }
+
+    /// @name Translating messages
+    /// Each function calls `callback(UMPMessage)` for every packet the
+    /// message translates to.
+    /// @{
+
+    template <class Callback>
+    void translate(ChannelMessage msg, Callback &&callback) {
+        UMPMessage packet;
+        if (translateChannelMessage(msg, packet))
+            callback(packet);
+    }
+    template <class Callback>
+    void translate(SysCommonMessage msg, Callback &&callback) {
+        callback(systemMessage(msg.header, msg.data1, msg.data2, msg.cable));
+    }
+    template <class Callback>
+    void translate(RealTimeMessage msg, Callback &&callback) {
+        callback(systemMessage(msg.message, 0x00, 0x00, msg.cable));
+    }
+    template <class Callback>
+    void translate(SysExMessage msg, Callback &&callback) {
+        SysExCursor cursor = beginSysEx(msg);
+        UMPMessage packet;
+        while (nextSysEx(cursor, packet))
+            callback(packet);
+    }
+
+    /// @}
+
+    /// Forget unfinished SysEx messages and the RPN and NRPN state.
+    void reset();
+
+  private:
+    struct SysExCursor {
+        const uint8_t *data;
+        uint16_t remaining;
+        Cable cable;
+        bool start, end, done;
+    };
+
+    bool translateChannelMessage(ChannelMessage msg, UMPMessage &packet);
+    static UMPMessage systemMessage(uint8_t status, uint8_t data1,
+                                    uint8_t data2, Cable cable);
+    SysExCursor beginSysEx(SysExMessage msg);
+    static bool nextSysEx(SysExCursor &cursor, UMPMessage &packet);
+
+    ParameterNumberAssembler parameterNumbers;
+    /// One bit per cable, set while a SysEx message is unfinished.
+    uint16_t sysexActive = 0;
+    UMPProtocol protocol;
+};
+
+END_CS_NAMESPACE
@@ -0,0 +1,42 @@
+#include "UMP_Parser.hpp"
+
+BEGIN_CS_NAMESPACE
+
+bool UMP_Parser::feed(uint32_t word) {
+    if (wordIndex == 0)
+        numWords = UMPMessage::getNumberOfWords(word);
+    if (wordIndex < 2)
+        message.words[wordIndex] = word;
+    if (++wordIndex < numWords)
+        return false;
+    wordIndex = 0;
+    return numWords <= 2;
+}
+
+bool UMP_Parser::parse(const uint32_t *&words, const uint32_t *end) {
+    while (words != end)
+        if (feed(*words++))
+            return true;
+    return false;
+}
+
+bool UMP_Parser::parse(const uint8_t *&data, const uint8_t *end) {
+    while (data != end) {
+        partialWord = partialWord << 8 | *data++;
+        if (++numBytes < 4)
+            continue;
+        numBytes = 0;
+        if (feed(partialWord))
+            return true;
+    }
+    return false;
+}
+
+void UMP_Parser::reset() {
+    partialWord = 0;
+    numBytes = 0;
+    wordIndex = 0;
+    numWords = 0;
+}
+
+END_CS_NAMESPACE
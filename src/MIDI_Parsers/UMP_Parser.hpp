@@ -0,0 +1,70 @@
+#pragma once
+
+#include "UMPMessage.hpp"
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   Splits a stream of 32-bit words into Universal MIDI Packets.
+ *
+ * The words can be fed one by one, as an array, or as bytes in network byte
+ * order (big-endian), which is how UMP streams are sent over byte-oriented
+ * transports and stored in files.
+ *
+ * Packets of 96 and 128 bits are skipped, because @ref UMPMessage can't
+ * store them.
+ *
+ * @ingroup MIDIParsers
+ */
+class UMP_Parser {
+  public:
+    /// Feed a single word to the parser.
+    /// @return True if a packet is available, retrieve it using
+    ///         @ref getMessage().
+    bool feed(uint32_t word);
+
+    /**
+     * @brief   Parse words until a packet is complete.
+     * @param[in,out] words
+     *          The words to parse. Points to the first word that wasn't
+     *          parsed yet when the function returns.
+     * @param   end
+     *          Pointer to one past the last word to parse.
+     * @return  True if a packet is available, false if all words were
+     *          consumed without completing one.
+     */
+    bool parse(const uint32_t *&words, const uint32_t *end);
+
+    /**
+     * @brief   Parse big-endian bytes until a packet is complete. Incomplete
+     *          words are kept until the next call.
+     * @param[in,out] data
+     *          The bytes to parse. Points to the first byte that wasn't
+     *          parsed yet when the function returns.
+     * @param   end
+     *          Pointer to one past the last byte to parse.
+     * @return  True if a packet is available, false if all bytes were
+     *          consumed without completing one.
+     */
+    bool parse(const uint8_t *&data, const uint8_t *end);
+
+    /// Get the latest packet.
+    UMPMessage getMessage() const { return message; }
+
+    /// Discard the partial packet and word. Use this to synchronize to the
+    /// start of a packet, e.g. after a transmission error.
+    void reset();
+
+  private:
+    UMPMessage message;
+    /// The word that is being assembled from bytes.
+    uint32_t partialWord = 0;
+    /// The number of bytes of @ref partialWord received so far.
+    uint8_t numBytes = 0;
+    /// The index of the next word of the current packet.
+    uint8_t wordIndex = 0;
+    /// The number of words of the current packet.
+    uint8_t numWords = 0;
+};
+
+END_CS_NAMESPACE
@@ -1,4 +1,5 @@
 #include "USBMIDI_Parser.hpp"
+#include "MIDIStatusTable.hpp"
 #include <Settings/SettingsWrapper.hpp>
 
 BEGIN_CS_NAMESPACE
@@ -20,8 +21,8 @@ MIDIReadEvent USBMIDI_Parser::handleSysExStartCont(MIDIUSBPacket_t packet,
         startSysEx(cable); // start a new message
                            // (overwrites previous unfinished message)
     }
-    // If we haven't received a SysExStart
-    else if (!receivingSysEx(cable)) {
+    // If we haven't received a SysExStart (or there was no memory for it)
+    if (!receivingSysEx(cable)) {
         DEBUGREF(F("No SysExStart received"));
         return MIDIReadEvent::NO_MESSAGE; // ignore the data
     }
@@ -55,8 +56,8 @@ MIDIReadEvent USBMIDI_Parser::handleSysExEnd(MIDIUSBPacket_t packet,
         startSysEx(cable); // start a new message
                            // (overwrites previous unfinished message)
     }
-    // If we haven't received a SysExStart
-    else if (!receivingSysEx(cable)) {
+    // If we haven't received a SysExStart (or there was no memory for it)
+    if (!receivingSysEx(cable)) {
         DEBUGFN(F("No SysExStart received"));
         return MIDIReadEvent::NO_MESSAGE; // ignore the data
     }
@@ -83,7 +84,8 @@ template <>
 MIDIReadEvent USBMIDI_Parser::handleSysExEnd<1>(MIDIUSBPacket_t packet,
                                                 Cable cable) {
     // Single-byte System Common Message
-    if (packet[1] != uint8_t(MIDIMessageType::SysExEnd)) {
+    if (MIDIStatusInfo::lookup(packet[1]).getClass() !=
+        MIDIStatusInfo::SysExEnd) {
         // System Common (1 byte)
         midimsg.header = packet[1];
         midimsg.cable = cable;
@@ -40,6 +40,22 @@ class USBMIDI_Parser : public MIDI_Parser {
     template <class BytePuller>
     MIDIReadEvent pull(BytePuller &&puller);
 
+    /**
+     * @brief   Parse one incoming MIDI message from an array of packets.
+     * @param[in,out] packet
+     *          Pointer to the first packet to parse. Advanced past the packets
+     *          that were consumed.
+     * @param   end
+     *          Pointer past the last packet.
+     * @return  The type of MIDI message available, or
+     *          `MIDIReadEvent::NO_MESSAGE` if all packets were consumed
+     *          before a complete message was parsed.
+     * 
+     * The packets are stored as 32-bit integers, with the Cable Number and
+     * Code Index Number in the least significant byte.
+     */
+    MIDIReadEvent parse(const uint32_t *&packet, const uint32_t *end);
+
   protected:
     /// Feed a new packet to the parser.
     MIDIReadEvent feed(MIDIUSBPacket_t packet);
@@ -74,8 +90,8 @@ class USBMIDI_Parser : public MIDI_Parser {
         activeCable = cable;
     }
     void endSysExChunk(Cable cable) { activeCable = cable; }
-    bool hasSysExSpace(Cable cable, uint8_t amount) const {
-        return sysexbuffers[cable.getRaw()].hasSpaceLeft(amount);
+    bool hasSysExSpace(Cable cable, uint8_t amount) {
+        return sysexbuffers[cable.getRaw()].reserve(amount);
     }
     void addSysExByte(Cable cable, uint8_t data) {
         sysexbuffers[cable.getRaw()].add(data);
@@ -123,4 +139,19 @@ inline MIDIReadEvent USBMIDI_Parser::pull(BytePuller &&puller) {
     return MIDIReadEvent::NO_MESSAGE;
 }
 
+inline MIDIReadEvent USBMIDI_Parser::parse(const uint32_t *&packet,
+                                           const uint32_t *end) {
+    MIDIReadEvent evt = resume();
+    if (evt != MIDIReadEvent::NO_MESSAGE)
+        return evt;
+    while (packet != end) {
+        uint32_t p = *packet++;
+        evt = feed({{uint8_t(p), uint8_t(p >> 8), uint8_t(p >> 16),
+                     uint8_t(p >> 24)}});
+        if (evt != MIDIReadEvent::NO_MESSAGE)
+            return evt;
+    }
+    return MIDIReadEvent::NO_MESSAGE;
+}
+
 END_CS_NAMESPACE
\ No newline at end of file
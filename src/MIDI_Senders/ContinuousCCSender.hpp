@@ -1,6 +1,7 @@
 #pragma once
 
 #include <AH/Math/IncreaseBitDepth.hpp>
+#include <MIDI_Parsers/UMPMessage.hpp>
 #include <midimap/midimap_class.hpp>
 
 BEGIN_CS_NAMESPACE
@@ -89,7 +90,8 @@ public:
 
   /// Send a 14-bit CC message to the given address.
   /// Sends two 7-bit CC packets, one for @p address (MSB), and one for
-  /// @p address + 0x20 (LSB).
+  /// @p address + 0x20 (LSB). The MSB is omitted if it's the same as the one
+  /// that was last sent to the same address, since the receiver still has it.
   void send(uint16_t value, MIDIAddress address)
   {
     uint16_t mappedValue;
@@ -111,11 +113,17 @@ public:
 
     // Only send if the value has changed
     if (mappedValue != _lastSentValue) {
-      midimap.sendControlChange(address + 0x00, (mappedValue >> 7) & 0x7F);
+      // Receivers reset the LSB when they receive a new MSB, so the MSB
+      // always has to go first, but it can be left out if it didn't change
+      bool sameMSB = address == _lastAddress &&
+                     (mappedValue >> 7) == (_lastSentValue >> 7);
+      if (!sameMSB)
+        midimap.sendControlChange(address + 0x00, (mappedValue >> 7) & 0x7F);
       midimap.sendControlChange(address + 0x20, (mappedValue >> 0) & 0x7F);
       
       // Update the last sent value
       _lastSentValue = mappedValue;
+      _lastAddress = address;
     }
   }
 
@@ -130,6 +138,77 @@ public:
 private:
   uint16_t _MinThreshold, _MaxThreshold;
   uint16_t _lastSentValue; // Store the last sent value
+  MIDIAddress _lastAddress; // The address the last value was sent to
+  bool _thresholdingEnabled; // Flag to indicate if thresholding is enabled
+};
+
+/**
+ * @brief   Class that sends continuous MIDI 2.0 control change messages with
+ *          a resolution of 32 bits.
+ *
+ * Each value is sent as a single 64-bit Universal MIDI Packet, so it reaches
+ * a MIDI 2.0 interface (e.g. @ref StreamUMP_Interface) with its full
+ * resolution. MIDI 1.0 interfaces send it as a 7-bit CC.
+ *
+ * @tparam  INPUT_PRECISION_BITS
+ *          The resolution of the input values. The values are scaled up to
+ *          32 bits using the min-center-max algorithm of the MIDI 2.0
+ *          specification.
+ *
+ * @ingroup MIDI_Senders
+ */
+template <uint8_t INPUT_PRECISION_BITS>
+class ContinuousCCSender32
+{
+public:
+  // Default constructor with full range (no thresholding)
+  ContinuousCCSender32() 
+      : _MinThreshold(0), _MaxThreshold(MaxValue), 
+        _lastSentValue(0xFFFFFFFF), _thresholdingEnabled(false) {}
+      
+  // Constructor with thresholds
+  ContinuousCCSender32(uint16_t MinThreshold, uint16_t MaxThreshold)
+      : _MinThreshold(MinThreshold), _MaxThreshold(MaxThreshold), 
+        _lastSentValue(0xFFFFFFFF), _thresholdingEnabled(true) {}
+
+  /// Send a 32-bit CC message to the given address.
+  void send(uint16_t value, MIDIAddress address)
+  {
+    if (_thresholdingEnabled) {
+      // Apply the threshold filter
+      if (value < _MinThreshold) {
+        value = _MinThreshold;
+      } else if (value > _MaxThreshold) {
+        value = _MaxThreshold;
+      }
+      
+      // Map the filtered value to the full input range
+      value = map(value, _MinThreshold, _MaxThreshold, 0, MaxValue);
+    }
+
+    // Only send if the value has changed
+    if (value != _lastSentValue) {
+      midimap.sendControlChange32(
+          address, scaleUpMIDIValue(value, INPUT_PRECISION_BITS, 32));
+      
+      // Update the last sent value
+      _lastSentValue = value;
+    }
+  }
+
+  /// Get this sender's precision.
+  constexpr static uint8_t precision()
+  {
+    static_assert(INPUT_PRECISION_BITS >= 2 && INPUT_PRECISION_BITS <= 16,
+                  "Resolution should be between 2 and 16 bits");
+    return INPUT_PRECISION_BITS;
+  }
+  
+private:
+  constexpr static uint16_t MaxValue = (1ul << INPUT_PRECISION_BITS) - 1;
+
+  uint16_t _MinThreshold, _MaxThreshold;
+  uint32_t _lastSentValue; // Store the last sent value
   bool _thresholdingEnabled; // Flag to indicate if thresholding is enabled
 };
 
@@ -1,53 +1,47 @@
 #pragma once
 
 #include <midimap/midimap_class.hpp>
-#include <Arduino.h>
+#include <AH/Hardware/Ultrasonic.hpp>
 
 BEGIN_CS_NAMESPACE
 
-class KeySender 
+class KeySender
 {
 public:
     KeySender(MIDIAddress address, pin_t pin)
-        : _address(address), _pin(pin) {}
+        : _address(address), _ultrasonic(pin) {}
 
-    void begin() 
+    void begin()
     {
-        pinMode(_pin, OUTPUT); // Set pin mode to input
+        _ultrasonic.begin();
     }
 
-    void update()  
-    {
-        digitalWrite(_pin, LOW);
-        delayMicroseconds(2);
-        digitalWrite(_pin, HIGH);
-        delayMicroseconds(10);
-        digitalWrite(_pin, LOW);
-
-        //pinMode(_pin, INPUT);
+    /// Get the sensor, e.g. to add it to an UltrasonicScheduler.
+    AH::Ultrasonic &getUltrasonic() { return _ultrasonic; }
 
-        long duration = pulseIn(_pin, HIGH, 30000); // Measure pulse duration
-         // Debugging line to print the duration
+    /// Set the time between two measurements, in microseconds.
+    void setInterval(unsigned long interval)
+    {
+        _ultrasonic.setInterval(interval);
+    }
 
-        if (duration == 0)
+    void update()
+    {
+        if (!_ultrasonic.update())
         {
-            return; // If there's no valid duration, don't send any message
+            return; // If there's no new measurement, don't send any message
         }
 
-        float distance = (duration / 2) * 0.0343; // Convert to distance in cm
-        uint8_t value = map(distance, 0, 100, 0, 127);
+        uint16_t distance = _ultrasonic.getDistanceMM();
+        int16_t value = map(distance, 0, 1000, 0, 127);
         value = constrain(value, 0, 127);
 
-        Serial.print("value: ");
-        Serial.println(value);
-
         midimap.sendKeyPressure(_address, value); // Send MIDI message
-        //pinMode(_pin, OUTPUT);                    // Set pin mode to input
     }
 
 private:
     MIDIAddress _address;
-    pin_t _pin;
+    AH::Ultrasonic _ultrasonic;
 };
 
 END_CS_NAMESPACE
@@ -23,25 +23,34 @@ public:
     UltrasonicCCSender (MIDIAddress address, pin_t pin)
             : _address(address), _ultrasonic(pin) {}
 
+    /// Get the sensor, e.g. to add it to an UltrasonicScheduler.
+    Ultrasonic &getUltrasonic() { return _ultrasonic; }
+
+    /// Set the time between two measurements, in microseconds.
+    void setInterval(unsigned long interval) {
+            _ultrasonic.setInterval(interval);
+    }
+
     void begin() {
             _ultrasonic.begin();
     }
 
     void update() {
-        uint16_t distance = _ultrasonic.readDistanceMM();
+        if (!_ultrasonic.update())
+            return; // No new measurement
+        uint16_t distance = _ultrasonic.getDistanceMM();
         int16_t value = map(distance, 100, 800, 127, 0);
         value = constrain(value, 0, 127);
 
-        static int16_t lastvalue = 0; // Invalid initial value to force first send
-        if (value != lastvalue) {
-            MIDIChannelCable channelCable = {_address.getChannel(), _address.getCableNumber()};
+        if (value != _lastValue) {
             midimap.sendControlChange(_address, value);
-            lastvalue = value;
+            _lastValue = value;
         }
     }
 private:
     MIDIAddress _address;   ///< MIDI address for sending key pressure.
     Ultrasonic _ultrasonic; ///< Ultrasonic sensor object.
+    int16_t _lastValue = -1; ///< Invalid initial value to force first send.
 };
 
 END_CS_NAMESPACE
\ No newline at end of file
@@ -27,9 +27,19 @@ class UltrasonicKPSender {
             _ultrasonic.begin();
         }
 
+        /// Get the sensor, e.g. to add it to an UltrasonicScheduler.
+        Ultrasonic &getUltrasonic() { return _ultrasonic; }
+
+        /// Set the time between two measurements, in microseconds.
+        void setInterval(unsigned long interval) {
+            _ultrasonic.setInterval(interval);
+        }
+
         void update() {
+            if (!_ultrasonic.update())
+                return; // No new measurement
             uint8_t mappedValue;
-            uint16_t distance = _ultrasonic.readDistanceMM();
+            uint16_t distance = _ultrasonic.getDistanceMM();
             //Serial.println(distance);
             if (_thresholdingEnabled) {
                 // Apply the threshold filter
@@ -38,7 +48,6 @@ class UltrasonicKPSender {
                 } else if (distance > _MaxThreshold) {
                     distance = _MaxThreshold;  // If value is above MaxThreshold, use MaxThreshold
                 }
-                Serial.println(_MaxThreshold);
                 // Map the filtered value to 0-127 range
                 mappedValue = map(distance, _MinThreshold, _MaxThreshold, 0, 127);
             } else {
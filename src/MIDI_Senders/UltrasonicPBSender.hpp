@@ -30,21 +30,30 @@ public:
             _ultrasonic.begin();
     }
 
+    /// Get the sensor, e.g. to add it to an UltrasonicScheduler.
+    Ultrasonic &getUltrasonic() { return _ultrasonic; }
+
+    /// Set the time between two measurements, in microseconds.
+    void setInterval(unsigned long interval) {
+            _ultrasonic.setInterval(interval);
+    }
+
     void update() {
-        uint16_t distance = _ultrasonic.readDistanceMM();
+        if (!_ultrasonic.update())
+            return; // No new measurement
+        uint16_t distance = _ultrasonic.getDistanceMM();
 
         // Map distance (0-1000mm) to pitch bend range (0 to 16383)
         int16_t pitchBendValue = map(distance, 100, 800, 16383, 0);
         pitchBendValue = constrain(pitchBendValue, 0, 16383);
         //Serial.print("hello");
 
-        static int16_t lastPitchBendValue = 0; // Invalid initial value to force first send
-        if (pitchBendValue != lastPitchBendValue) {
+        if (pitchBendValue != _lastPitchBendValue) {
             MIDIChannelCable channelCable = {_address.getChannel(), _address.getCableNumber()};
             //Serial.println(pitchBendValue);
             //Serial.print("hello");
             midimap.sendPitchBend(channelCable, pitchBendValue);
-            lastPitchBendValue = pitchBendValue;
+            _lastPitchBendValue = pitchBendValue;
         }
     }
 
@@ -57,6 +66,7 @@ public:
 private:
     MIDIAddress _address;   ///< MIDI address for sending key pressure.
     Ultrasonic _ultrasonic; ///< Ultrasonic sensor object.
+    int16_t _lastPitchBendValue = -1; ///< Invalid initial value to force first send.
 };
 
 END_CS_NAMESPACE
\ No newline at end of file
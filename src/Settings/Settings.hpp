@@ -43,11 +43,107 @@ constexpr uint8_t NOTE_VELOCITY_THRESHOLD = 1;
 /// Don't include code for sending System Exclusive messages.
 #define NO_SYSEX_OUTPUT 0
 
-/// The length of the maximum System Exclusive message that can be received.
+/// The size of the memory block that is leased from the @ref SysExBufferPool
+/// when a System Exclusive message starts. Longer messages grow the block in
+/// steps of this size, for as long as there's space in the pool.
 /// The maximum length sent by the MCU protocol is 120 bytes.
 constexpr uint16_t SYSEX_BUFFER_SIZE = 128;
 
-/// Timeout in milliseconds to wait for a SysEx chunk to complete.
+/// The maximum number of System Exclusive messages that can be received at
+/// the same time (on different MIDI interfaces or cables). Increase it if
+/// more than one interface receives SysEx at the same time, e.g. USB and a
+/// serial port on AVR.
+#ifdef __AVR__
+constexpr uint8_t SYSEX_BUFFER_POOL_BLOCKS = 1;
+#else
+constexpr uint8_t SYSEX_BUFFER_POOL_BLOCKS = 4;
+#endif
+
+/// The total size of the memory that is shared by the SysEx buffers of all
+/// MIDI parsers. By default, one @ref SYSEX_BUFFER_SIZE block for each message
+/// that can be received at the same time: 128 bytes on AVR, 512 bytes on
+/// other platforms.
+constexpr uint16_t SYSEX_BUFFER_POOL_SIZE =
+    SYSEX_BUFFER_POOL_BLOCKS * SYSEX_BUFFER_SIZE;
+
+/// The maximum number of messages returned by a single call to
+/// @ref SerialMIDI_Parser::parse(const uint8_t *, const uint8_t *).
+constexpr uint8_t SERIAL_MIDI_PARSE_BATCH_SIZE = 8;
+
+/// The number of bytes a serial MIDI interface reads from its stream at once.
+constexpr uint8_t SERIAL_MIDI_READ_BUFFER_SIZE = 32;
+
+/// The number of USB MIDI events that fit in one USB packet of a 64-byte
+/// full-speed bulk endpoint.
+constexpr uint8_t USB_MIDI_EVENTS_PER_PACKET = 16;
+
+/// The number of USB MIDI packets a USB MIDI interface reads from or writes to
+/// its backend at once. Each interface has a receive and a transmit buffer of
+/// this many 4-byte packets. It is also the number of packets a transaction
+/// can hold back, see @ref GenericUSBMIDI_Interface::alwaysSendImmediately.
+#ifdef __AVR__
+constexpr uint8_t USB_MIDI_PACKET_BATCH_SIZE = 4;
+#else
+constexpr uint8_t USB_MIDI_PACKET_BATCH_SIZE = USB_MIDI_EVENTS_PER_PACKET;
+#endif
+
+/// The default deadline of @ref AdaptiveUSBMIDI_FlushPolicy: the maximum time
+/// (in microseconds) that a buffered USB MIDI message is delayed. One
+/// full-speed USB frame.
+constexpr unsigned long USB_MIDI_FLUSH_DEADLINE = 1000;
+
+/// The number of channels for which @ref ParameterNumberAssembler keeps track
+/// of the selected RPN or NRPN and its value. When more channels are in use,
+/// the least recently used one is forgotten.
+constexpr uint8_t NRPN_INPUT_SLOTS = 4;
+
+/// The number of channels for which a MIDI sender remembers the last RPN or
+/// NRPN it sent (see @ref ParameterNumberEncoder).
+constexpr uint8_t NRPN_OUTPUT_SLOTS = 2;
+
+/// The number of 14-bit controllers for which @ref ControlChange14Assembler
+/// remembers the MSB. When more controllers are in use, the least recently
+/// used one is forgotten.
+constexpr uint8_t CC14_INPUT_SLOTS = 8;
+
+/// Keep an index of the MIDI input elements, keyed on their MIDI address, so
+/// incoming channel messages don't have to be offered to every element.
+/// @see    MIDIInputElement::getDispatchAddress
+#define MIDI_INPUT_DISPATCH_INDEX 0
+
+/// The number of hash buckets per MIDI input element type in the dispatch
+/// index. Must be a power of two.
+constexpr uint8_t MIDI_INPUT_DISPATCH_BUCKETS = 32;
+
+/// The maximum time in microseconds that outgoing MIDI messages are held
+/// during a transaction before they are sent anyway.
+/// @see    midimap_::setTransactionMode
+constexpr unsigned long MIDI_TRANSACTION_MAX_LATENCY = 2000; // microseconds
+
+/// The number of continuous controllers whose latest value can be held by a
+/// @ref CoalescingMIDI_Pipe at the same time.
+constexpr uint8_t MIDI_COALESCING_SLOTS = 16;
+
+/// The default minimum time in microseconds between two flushes of a
+/// @ref CoalescingMIDI_Pipe. Zero flushes on every call to `sendNow()`, i.e.
+/// once per @ref midimap_::loop().
+constexpr unsigned long MIDI_COALESCING_INTERVAL = 0; // microseconds
+
+/// The default maximum number of bytes a @ref RateLimitedMIDI_Pipe sends in
+/// a single burst.
+constexpr uint16_t MIDI_RATE_LIMIT_BURST = 32;
+
+/// The number of messages (other than continuous controllers) a
+/// @ref RateLimitedMIDI_Pipe can defer.
+constexpr uint8_t MIDI_RATE_LIMIT_QUEUE_SIZE = 16;
+
+/// The default size of the ring buffer of a @ref QueuedMIDI_Pipe, in bytes.
+/// Must be a power of two.
+constexpr uint16_t MIDI_QUEUE_CAPACITY = 256;
+
+/// Timeout in milliseconds to wait for a SysEx chunk to complete. Unfinished
+/// incoming SysEx messages that stall for longer than this may lose their
+/// buffer when the @ref SysExBufferPool runs out of memory.
 constexpr unsigned long SYSEX_CHUNK_TIMEOUT = 500;
 
 /// The baud rate to use for Hairless MIDI.
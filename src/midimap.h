@@ -30,6 +30,7 @@
 
 #include <MIDI_Outputs/CCPotentiometer.hpp>
 #include <MIDI_Outputs/CCPotentiometer14.hpp>
+#include <MIDI_Outputs/CCPotentiometer32.hpp>
 #include <MIDI_Outputs/PBPotentiometer.hpp>
 
 #include <MIDI_Outputs/CCTouch.hpp>
@@ -55,9 +56,14 @@
 #include <MIDI_Interfaces/DebugMIDI_Interface.hpp>
 #include <MIDI_Interfaces/USBMIDI_Interface.hpp>
 #include <MIDI_Interfaces/BluetoothMIDI_Interface.hpp>
+#include <MIDI_Interfaces/StreamUMP_Interface.hpp>
+#include <MIDI_Parsers/SysExPacking.hpp>
 
 // ------------------------- Extended Input Output -------------------------- //
 #include <AH/Hardware/ExtendedInputOutput/ExtendedInputOutput.hpp>
+#include <AH/Hardware/AnalogScanGroup.hpp>
+#include <AH/Filters/FilterBank.hpp>
+#include <AH/Math/CurveLUT.hpp>
 
 // ----------------------------- MIDI Constants ----------------------------- //
 #include <MIDI_Constants/Control_Change.hpp>
@@ -41,10 +41,14 @@ void midimap_::begin()
     MIDIInputElementCP::beginAll();
     MIDIInputElementPB::beginAll();
     MIDIInputElementSysEx::beginAll();
+    MIDIInputElementParameter::beginAll();
+    MIDIInputElementCC14::beginAll();
     Updatable<>::beginAll();
     //    Updatable<Display>::beginAll();
     //    displayTimer.begin();
-    
+#if UPDATABLE_PROFILING
+    resetProfiles();
+#endif
 }
 
 bool midimap_::connectDefaultMIDI_Interface()
@@ -70,6 +74,8 @@ void midimap_::disconnectMIDI_Interfaces()
 
 void midimap_::loop()
 {
+    if (transactionMode)
+        beginTransaction();
     ExtendedIOElement::updateAllBufferedInputs();
     Updatable<>::updateAll();
     updateMidiInput();
@@ -77,8 +83,156 @@ void midimap_::loop()
     //    if (displayTimer)
     //        updateDisplays();
     ExtendedIOElement::updateAllBufferedOutputs();
+    if (transactionActive)
+        endTransaction();
+    else if (outpipe.isEnabled())
+        this->sourceNowToPipe();
+}
+
+void midimap_::beginTransaction()
+{
+    this->sourceTransactionToPipe(true);
+    transactionActive = true;
+    transactionHolding = false;
+}
+
+void midimap_::endTransaction()
+{
+    this->sourceTransactionToPipe(false);
+    transactionActive = false;
+    this->sourceNowToPipe();
+}
+
+void midimap_::checkTransactionLatency()
+{
+    if (!transactionActive)
+        return;
+    unsigned long now = micros();
+    if (!transactionHolding)
+    {
+        transactionHolding = true;
+        transactionStart = now;
+    }
+    else if (now - transactionStart >= transactionMaxLatency)
+    {
+        sendNowImpl();
+    }
+}
+
+#if UPDATABLE_PROFILING
+
+void midimap_::resetProfiles()
+{
+    Updatable<>::resetAllProfiles();
+    Updatable<MIDI_Interface>::resetAllProfiles();
+    Updatable<MIDI_Interface>::forEachProfile(
+        [](uint8_t, Updatable<MIDI_Interface> &el)
+        { static_cast<MIDI_Interface &>(el).resetDispatchProfile(); });
+    MIDIInputElementNote::resetAllProfiles();
+    MIDIInputElementKP::resetAllProfiles();
+    MIDIInputElementCC::resetAllProfiles();
+    MIDIInputElementPC::resetAllProfiles();
+    MIDIInputElementCP::resetAllProfiles();
+    MIDIInputElementPB::resetAllProfiles();
+    MIDIInputElementSysEx::resetAllProfiles();
+    MIDIInputElementParameter::resetAllProfiles();
+    MIDIInputElementCC14::resetAllProfiles();
+}
+
+void midimap_::printProfiles(Print &os)
+{
+    Updatable<>::printAllProfiles(os, "update");
+    Updatable<MIDI_Interface>::printAllProfiles(os, "midi");
+    Updatable<MIDI_Interface>::forEachProfile(
+        [&](uint8_t index, Updatable<MIDI_Interface> &el)
+        {
+            static_cast<MIDI_Interface &>(el).getDispatchProfile().print(
+                os, "dispatch", index);
+        });
+    MIDIInputElementNote::printAllProfiles(os, "note");
+    MIDIInputElementKP::printAllProfiles(os, "kp");
+    MIDIInputElementCC::printAllProfiles(os, "cc");
+    MIDIInputElementPC::printAllProfiles(os, "pc");
+    MIDIInputElementCP::printAllProfiles(os, "cp");
+    MIDIInputElementPB::printAllProfiles(os, "pb");
+    MIDIInputElementSysEx::printAllProfiles(os, "sysex");
+    MIDIInputElementParameter::printAllProfiles(os, "nrpn");
+    MIDIInputElementCC14::printAllProfiles(os, "cc14");
+}
+
+void midimap_::printProfiles(StreamDebugMIDI_Output &output)
+{
+    printProfiles(output.getStream());
 }
 
+namespace
+{
+
+/// Write the given value as @p n 7-bit groups, most significant first,
+/// saturating if it doesn't fit.
+uint8_t *encodeProfileValue(uint8_t *out, uint32_t value, uint8_t n)
+{
+    uint32_t limit = (uint32_t(1) << (7 * n)) - 1;
+    if (value > limit)
+        value = limit;
+    for (uint8_t i = n; i-- > 0;)
+        *out++ = (value >> (7 * i)) & 0x7F;
+    return out;
+}
+
+void sendProfile(uint8_t group, uint8_t index, const AH::UpdateProfile &profile,
+                 Cable cable)
+{
+    uint8_t data[6 + 4 + 3 + 3 + 3 + 2 * AH::UPDATE_PROFILE_BUCKETS + 1];
+    uint8_t *out = data;
+    *out++ = 0xF0;
+    *out++ = 0x7D; // Non-commercial manufacturer ID
+    *out++ = 'P';
+    *out++ = group;
+    *out++ = index & 0x7F;
+    out = encodeProfileValue(out, profile.count, 4);
+    out = encodeProfileValue(out, profile.last, 3);
+    out = encodeProfileValue(out, profile.max, 3);
+    out = encodeProfileValue(out, profile.getMean(), 3);
+    for (uint16_t bucket : profile.histogram)
+        out = encodeProfileValue(out, bucket, 2);
+    *out++ = 0xF7;
+    midimap.sendSysEx(data, out - data, cable);
+}
+
+template <class T>
+void sendAllProfiles(uint8_t group, Cable cable)
+{
+    T::forEachProfile([&](uint8_t index, T &el)
+                      { sendProfile(group, index, el.getProfile(), cable); });
+}
+
+} // namespace
+
+void midimap_::sendProfiles(Cable cable)
+{
+    sendAllProfiles<Updatable<>>(0, cable);
+    sendAllProfiles<Updatable<MIDI_Interface>>(1, cable);
+    Updatable<MIDI_Interface>::forEachProfile(
+        [&](uint8_t index, Updatable<MIDI_Interface> &el)
+        {
+            sendProfile(2, index,
+                        static_cast<MIDI_Interface &>(el).getDispatchProfile(),
+                        cable);
+        });
+    sendAllProfiles<MIDIInputElementNote>(3, cable);
+    sendAllProfiles<MIDIInputElementKP>(4, cable);
+    sendAllProfiles<MIDIInputElementCC>(5, cable);
+    sendAllProfiles<MIDIInputElementPC>(6, cable);
+    sendAllProfiles<MIDIInputElementCP>(7, cable);
+    sendAllProfiles<MIDIInputElementPB>(8, cable);
+    sendAllProfiles<MIDIInputElementSysEx>(9, cable);
+    sendAllProfiles<MIDIInputElementParameter>(10, cable);
+    sendAllProfiles<MIDIInputElementCC14>(11, cable);
+}
+
+#endif
+
 void midimap_::updateMidiInput()
 {
     Updatable<MIDI_Interface>::updateAll();
@@ -87,19 +241,32 @@ void midimap_::updateMidiInput()
 void midimap_::sendChannelMessageImpl(ChannelMessage msg)
 {
     this->sourceMIDItoPipe(msg);
+    checkTransactionLatency();
 }
 void midimap_::sendSysExImpl(SysExMessage msg)
 {
     this->sourceMIDItoPipe(msg);
+    checkTransactionLatency();
 }
 void midimap_::sendSysCommonImpl(SysCommonMessage msg)
 {
     this->sourceMIDItoPipe(msg);
+    checkTransactionLatency();
 }
 void midimap_::sendRealTimeImpl(RealTimeMessage msg)
 {
     this->sourceMIDItoPipe(msg);
 }
+void midimap_::sendUMPImpl(UMPMessage msg)
+{
+    this->sourceMIDItoPipe(msg);
+    checkTransactionLatency();
+}
+void midimap_::sendNowImpl()
+{
+    this->sourceNowToPipe();
+    transactionHolding = false;
+}
 
 void midimap_::sinkMIDIfromPipe(ChannelMessage midimsg)
 {
@@ -118,11 +285,20 @@ void midimap_::sinkMIDIfromPipe(ChannelMessage midimsg)
     if (channelMessageCallback && channelMessageCallback(midimsg))
         return;
 
+    // Assemble RPN and NRPN values and 14-bit controllers from their
+    // Control Change messages
+    if (parameterNumbers.feed(midimsg))
+        MIDIInputElementParameter::updateAllWith(parameterNumbers.getMessage());
+    else if (controllers14.feed(midimsg))
+        MIDIInputElementCC14::updateAllWith(controllers14.getMessage());
+
     if (midimsg.getMessageType() == MIDIMessageType::CONTROL_CHANGE &&
         midimsg.getData1() == MIDI_CC::Reset_All_Controllers)
     {
         // Reset All Controllers
         DEBUG(F("Reset All Controllers"));
+        parameterNumbers.reset();
+        controllers14.reset();
         MIDIInputElementCC::resetAll();
         MIDIInputElementCP::resetAll();
     }
@@ -264,6 +440,8 @@ void midimap_::updateInputs()
     MIDIInputElementCP::updateAll();
     MIDIInputElementPB::updateAll();
     MIDIInputElementSysEx::updateAll();
+    MIDIInputElementParameter::updateAll();
+    MIDIInputElementCC14::updateAll();
 }
 /*
 void midimap_::beginDisplays() {
@@ -13,11 +13,16 @@
 #include <AH/Timing/MillisMicrosTimer.hpp>
 //#include <Display/DisplayElement.hpp>
 //#include <Display/DisplayInterface.hpp>
+#include <MIDI_Interfaces/CoalescingMIDI_Pipe.hpp>
 #include <MIDI_Interfaces/MIDI_Interface.hpp>
+#include <MIDI_Parsers/ControlChange14Assembler.hpp>
+#include <MIDI_Parsers/ParameterNumberAssembler.hpp>
 #include <Settings/SettingsWrapper.hpp>
 
 BEGIN_CS_NAMESPACE
 
+class StreamDebugMIDI_Output;
+
 using AH::FilteredAnalog;
 using AH::NormalUpdatable;
 //using AH::Timer;
@@ -71,6 +76,69 @@ void disconnectMIDI_Interfaces();
 void updateMidiInput();
 /// Update all MIDIInputElement%s.
 void updateInputs();
+
+#if UPDATABLE_PROFILING || defined(DOXYGEN)
+/// @name Profiling
+/// @{
+
+/// Clear the timing statistics of all elements and MIDI interfaces. Called
+/// at the end of @ref begin().
+void resetProfiles();
+/// Print the timing statistics of all elements and MIDI interfaces.
+void printProfiles(Print &os);
+/// Print the timing statistics to the stream of a debug MIDI output.
+void printProfiles(StreamDebugMIDI_Output &output);
+/// Send the timing statistics of all elements and MIDI interfaces as SysEx
+/// messages, one per element:
+/// `F0 7D 50 <group> <index> <count:4> <last:3> <max:3> <mean:3> 
+/// <histogram:2×N> F7`, with all numbers in 7-bit groups, most significant
+/// first, and saturated if they don't fit.
+/// The groups are 0 for the Updatable elements, 1 for the MIDI interface
+/// updates, 2 for handling their incoming messages, 3 to 9 for the
+/// MIDI input elements (Note, Key Pressure, Control Change, Program
+/// Change, Channel Pressure, Pitch Bend, SysEx), 10 for the (N)RPN input
+/// elements, and 11 for the 14-bit Control Change input elements.
+void sendProfiles(Cable cable = Cable_1);
+
+/// @}
+#endif
+
+/// @name Batching outgoing MIDI
+/// @{
+
+/// Hold all MIDI messages sent during one pass of @ref loop(), and send them
+/// together at the end, instead of sending each message on its own (e.g. as a
+/// separate USB transfer). Messages are sent early if they have been held for
+/// longer than the maximum latency.
+/// @see    setTransactionMaxLatency
+void setTransactionMode(bool enabled) { transactionMode = enabled; }
+/// @see    setTransactionMode
+bool getTransactionMode() const { return transactionMode; }
+/// Set the maximum time in microseconds that messages are held during a
+/// transaction.
+void setTransactionMaxLatency(unsigned long maxLatency) {
+this->transactionMaxLatency = maxLatency;
+}
+
+/// @}
+
+/// @name Coalescing outgoing MIDI
+/// @{
+
+/// Only send the latest value of continuous controllers (Control Change,
+/// Pitch Bend, Pressure) that change several times before they can be sent,
+/// e.g. when a fader moves faster than a slow MIDI link can keep up with.
+/// The values are sent at the end of every @ref loop(), or less often if an
+/// interval is set using `getOutputPipe().setInterval()`.
+/// Only applies to the default MIDI interface.
+/// @see    CoalescingMIDI_Pipe
+void setCoalescing(bool enabled) { outpipe.setEnabled(enabled); }
+/// @see    setCoalescing
+bool getCoalescing() const { return outpipe.isEnabled(); }
+/// Get the pipe between Control Surface and the default MIDI interface.
+CoalescingMIDI_Pipe &getOutputPipe() { return outpipe; }
+
+/// @}
 /// Initialize all displays that have at least one display element.
 //void beginDisplays();
 /// Clear, draw and display all displays that contain display elements that
@@ -86,9 +154,17 @@ void sendSysCommonImpl(SysCommonMessage);
 void sendSysExImpl(SysExMessage);
 /// Low-level function for sending a MIDI real-time message.
 void sendRealTimeImpl(RealTimeMessage);
+/// Low-level function for sending a Universal MIDI Packet.
+void sendUMPImpl(UMPMessage);
 /// Low-level function for sending any buffered outgoing MIDI messages.
-/// @todo Implement this in MIDI_Pipe
-void sendNowImpl() { /* TODO */ }
+void sendNowImpl();
+
+/// Start holding outgoing messages.
+void beginTransaction();
+/// Send all held messages and stop holding.
+void endTransaction();
+/// Send the held messages if the oldest one exceeds the maximum latency.
+void checkTransactionLatency();
 
 private:
 void sinkMIDIfromPipe(ChannelMessage msg) override;
@@ -140,7 +216,15 @@ ChannelMessageCallback channelMessageCallback = nullptr;
 SysExMessageCallback sysExMessageCallback = nullptr;
 SysCommonMessageCallback sysCommonMessageCallback = nullptr;
 RealTimeMessageCallback realTimeMessageCallback = nullptr;
-MIDI_Pipe inpipe, outpipe;
+MIDI_Pipe inpipe;
+CoalescingMIDI_Pipe outpipe {false};
+ParameterNumberAssembler parameterNumbers;
+ControlChange14Assembler controllers14;
+bool transactionMode = false;
+bool transactionActive = false;
+bool transactionHolding = false;
+unsigned long transactionStart = 0;
+unsigned long transactionMaxLatency = MIDI_TRANSACTION_MAX_LATENCY;
 };
 
 #if CS_TRUE_MIDIMAP_INSTANCE || defined(DOXYGEN)